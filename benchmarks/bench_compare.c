@@ -0,0 +1,194 @@
+#include "benchmarks/bench_report.h"
+
+#define COMPARE_MAX_BENCHMARKS 256
+#define COMPARE_LINE_LIMIT 8192
+#define COMPARE_DEFAULT_THRESHOLD 5.0
+#define COMPARE_DEFAULT_MAD_FACTOR 3.0
+
+typedef struct {
+    BenchResult result;
+    char unit[32];
+} CompareEntry;
+
+typedef struct {
+    CompareEntry* entries;
+    int entryCount;
+} CompareRun;
+
+// Copies the string value of "key": out of the line into value, returns 0 if it was there.
+static int ReadString(const char* line, const char* key, char* value, size_t valueSize) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\":\"", key);
+    const char* start = strstr(line, pattern);
+
+    if (start == 0) {
+        return 1;
+    }
+
+    start += strlen(pattern);
+    const char* end = start;
+
+    // Escapes stay as they are, both runs are compared in the same form.
+    while (*end != '\0' && *end != '"') {
+        end += end[0] == '\\' && end[1] != '\0' ? 2 : 1;
+    }
+
+    if (*end != '"' || (size_t)(end - start) >= valueSize) {
+        return 1;
+    }
+
+    memcpy(value, start, end - start);
+    value[end - start] = '\0';
+    return 0;
+}
+
+// Reads one line of Bench_Print back, returns 0 if it had a name and at least one run.
+static int ParseLine(const char* line, CompareEntry* entry) {
+    char better[16];
+    memset(entry, 0, sizeof(*entry));
+
+    if (ReadString(line, "benchmark", entry->result.name, sizeof(entry->result.name)) != 0 ||
+        ReadString(line, "unit", entry->unit, sizeof(entry->unit)) != 0 ||
+        ReadString(line, "better", better, sizeof(better)) != 0) {
+        return 1;
+    }
+
+    entry->result.unit = entry->unit;
+    entry->result.higherIsBetter = strcmp(better, "higher") == 0;
+
+    const char* runs = strstr(line, "\"runs\":[");
+
+    if (runs == 0) {
+        return 1;
+    }
+
+    runs += strlen("\"runs\":[");
+
+    while (*runs != ']' && entry->result.runCount < BENCH_MAX_RUNS) {
+        char* end;
+        double value = strtod(runs, &end);
+
+        if (end == runs) {
+            break;
+        }
+
+        entry->result.runs[entry->result.runCount++] = value;
+        runs = *end == ',' ? end + 1 : end;
+    }
+
+    return entry->result.runCount == 0;
+}
+
+// Loads every benchmark line of a bench.json, returns 0 on success. Lines that aren't one are skipped.
+static int CompareRun_Load(CompareRun* run, const char* path) {
+    FILE* file = fopen(path, "r");
+
+    if (file == 0) {
+        return 1;
+    }
+
+    static char line[COMPARE_LINE_LIMIT];
+    run->entries = malloc(COMPARE_MAX_BENCHMARKS * sizeof(CompareEntry));
+    run->entryCount = 0;
+
+    while (run->entries != 0 && run->entryCount < COMPARE_MAX_BENCHMARKS && fgets(line, sizeof(line), file) != 0) {
+        if (ParseLine(line, &run->entries[run->entryCount]) == 0) {
+            run->entryCount++;
+        }
+    }
+
+    fclose(file);
+    return run->entries == 0;
+}
+
+static const CompareEntry* CompareRun_Find(const CompareRun* run, const char* name) {
+    for (int i = 0; i < run->entryCount; i++) {
+        if (strcmp(run->entries[i].result.name, name) == 0) {
+            return &run->entries[i];
+        }
+    }
+
+    return 0;
+}
+
+// Reads the value after option out of the arguments, like Bench_ParseRuns.
+static double ParseOption(int* argc, char** argv, const char* option, double defaultValue) {
+    for (int i = 1; i + 1 < *argc; i++) {
+        if (strcmp(argv[i], option) == 0) {
+            double value = atof(argv[i + 1]);
+            memmove(argv + i, argv + i + 2, (*argc - i - 2) * sizeof(char*));
+            *argc -= 2;
+            return value;
+        }
+    }
+
+    return defaultValue;
+}
+
+int main(int argc, char** argv) {
+    double threshold = ParseOption(&argc, argv, "--threshold", COMPARE_DEFAULT_THRESHOLD);
+    double madFactor = ParseOption(&argc, argv, "--mad", COMPARE_DEFAULT_MAD_FACTOR);
+
+    if (argc != 3) {
+        printf("Usage: %s [--threshold <percent>] [--mad <factor>] <baseline bench.json> <bench.json>\n"
+               "Compares the medians of every benchmark in both runs. A benchmark regressed when its median got worse by more\n"
+               "than the threshold (default %.0f%%) and by more than factor times the MAD of both runs (default %.0f), so\n"
+               "noisy runs don't count. Exits with 1 when one did.\n",
+               argv[0], COMPARE_DEFAULT_THRESHOLD, COMPARE_DEFAULT_MAD_FACTOR);
+        return 1;
+    }
+
+    CompareRun baseline;
+    CompareRun current;
+
+    if (CompareRun_Load(&baseline, argv[1]) != 0) {
+        printf("Unable to open file with the provided path: %s\n", argv[1]);
+        return 1;
+    }
+
+    if (CompareRun_Load(&current, argv[2]) != 0) {
+        printf("Unable to open file with the provided path: %s\n", argv[2]);
+        free(baseline.entries);
+        return 1;
+    }
+
+    int regressionCount = 0;
+    printf("%-40s %12s %12s %9s %10s\n", "benchmark", "baseline", "run", "change", "");
+
+    for (int i = 0; i < current.entryCount; i++) {
+        const BenchResult* run = &current.entries[i].result;
+        const CompareEntry* baseEntry = CompareRun_Find(&baseline, run->name);
+        double runMedian = Bench_Median(run->runs, run->runCount);
+
+        if (baseEntry == 0) {
+            printf("%-40s %12s %12.6g %9s %10s\n", run->name, "-", runMedian, "", "new");
+            continue;
+        }
+
+        const BenchResult* base = &baseEntry->result;
+        double baseMedian = Bench_Median(base->runs, base->runCount);
+        double difference = runMedian - baseMedian;
+        double change = baseMedian != 0 ? difference / baseMedian * 100 : 0;
+        double noise = madFactor * (Bench_Mad(base->runs, base->runCount) + Bench_Mad(run->runs, run->runCount));
+        int isWorse = run->higherIsBetter ? difference < 0 : difference > 0;
+        int isSignificant = (change > threshold || change < -threshold) && (difference > noise || difference < -noise);
+        const char* verdict = !isSignificant ? "" : isWorse ? "REGRESSION" : "improved";
+
+        regressionCount += isSignificant && isWorse;
+        printf("%-40s %12.6g %12.6g %+8.1f%% %10s\n", run->name, baseMedian, runMedian, change, verdict);
+    }
+
+    for (int i = 0; i < baseline.entryCount; i++) {
+        if (CompareRun_Find(&current, baseline.entries[i].result.name) == 0) {
+            printf("%-40s %12.6g %12s %9s %10s\n", baseline.entries[i].result.name,
+                   Bench_Median(baseline.entries[i].result.runs, baseline.entries[i].result.runCount), "-", "", "missing");
+        }
+    }
+
+    printf("%d of %d benchmarks regressed\n", regressionCount, current.entryCount);
+
+    free(baseline.entries);
+    free(current.entries);
+
+    return regressionCount > 0;
+}
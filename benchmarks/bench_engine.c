@@ -0,0 +1,169 @@
+#include "benchmarks/bench_report.h"
+#include "engine/log_table.h"
+#include "engine/log_filter.h"
+#include "engine/log_aggregate.h"
+#include "engine/log_session.h"
+
+// Each run repeats its operation until at least this long went by, so small logs still give steady numbers.
+#define BENCH_MIN_RUN_SECONDS 0.2
+
+// The search bar kinds: a substring of any cell, equality on a dictionary, an address prefix, a derived column,
+// and regular expressions over every column and over one.
+static const char* FILTER_EXPRESSIONS[] = {
+    "mozilla", "sc-status = 500", "c-ip in 10.0.0.0/8", "route = /api/orders/{id}",
+    "~ /api/(orders|v2/products)/\\d+", "cs-uri-stem ~ \\.(php|env)$", "any /wp-login.php /.env /admin/config.php sqlmap"
+};
+
+static const char* GROUP_BY_COLUMNS[] = { "route", "c-ip", "sc-status" };
+
+typedef enum {
+    BENCH_PARSE,
+    BENCH_FILTER,
+    BENCH_GROUP_BY,
+    BENCH_SESSIONS
+} BenchKind;
+
+typedef struct {
+    BenchKind kind;
+    const char* path;
+    LogTable* table;
+    LogFilter* filter;
+    uint32_t* rows;
+    int column;
+} BenchJob;
+
+// Does the job once, returns 0 on success.
+static int RunOnce(const BenchJob* job) {
+    if (job->kind == BENCH_PARSE) {
+        LogTable table;
+
+        if (LogTable_Load(&table, job->path) != 0) {
+            return 1;
+        }
+
+        LogTable_Free(&table);
+    } else if (job->kind == BENCH_FILTER) {
+        LogFilter_Apply(job->filter, job->table, job->rows);
+    } else if (job->kind == BENCH_GROUP_BY) {
+        LogAggregate aggregate;
+
+        if (LogAggregate_Build(&aggregate, job->table, job->column, 0, 0) != 0) {
+            return 1;
+        }
+
+        LogAggregate_Free(&aggregate);
+    } else {
+        LogSessions sessions;
+
+        if (LogSessions_Build(&sessions, job->table, 0, 0, LOG_SESSION_DEFAULT_TIMEOUT) != 0) {
+            return 1;
+        }
+
+        LogSessions_Free(&sessions);
+    }
+
+    return 0;
+}
+
+// Seconds one run of the job takes, averaged over as many as fit in BENCH_MIN_RUN_SECONDS, or -1 on failure.
+static double TimeRun(const BenchJob* job) {
+    double start = Bench_Seconds();
+    double elapsed = 0;
+    int count = 0;
+
+    while (elapsed < BENCH_MIN_RUN_SECONDS) {
+        if (RunOnce(job) != 0) {
+            return -1;
+        }
+
+        count++;
+        elapsed = Bench_Seconds() - start;
+    }
+
+    return elapsed / count;
+}
+
+// Fills in the runs of result, each one work / seconds, or seconds * 1000 when work is 0. Returns 0 on success.
+static int Measure(BenchResult* result, const BenchJob* job, int runCount, double work) {
+    result->runCount = runCount;
+
+    for (int i = 0; i < runCount; i++) {
+        double seconds = TimeRun(job);
+
+        if (seconds < 0) {
+            return 1;
+        }
+
+        result->runs[i] = work > 0 ? work / seconds : seconds * 1000;
+    }
+
+    Bench_Print(result);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int runCount = Bench_ParseRuns(&argc, argv);
+
+    if (argc != 2) {
+        printf("Usage: %s [--runs <n>] <log file>\n"
+               "Loading, filtering, group-by and session throughput and latency over the log, one JSON object per line.\n",
+               argv[0]);
+        return 1;
+    }
+
+    LogTable table;
+
+    if (LogTable_Load(&table, argv[1]) != 0) {
+        printf("Unable to open file with the provided path: %s\n", argv[1]);
+        return 1;
+    }
+
+    uint32_t* rows = malloc((table.rowCount > 0 ? table.rowCount : 1) * sizeof(uint32_t));
+    int result = rows == 0;
+
+    if (result == 0) {
+        BenchResult parse = { .name = "parse", .unit = "MB/s", .higherIsBetter = 1 };
+        BenchJob job = { .kind = BENCH_PARSE, .path = argv[1] };
+        result |= Measure(&parse, &job, runCount, table.sourceSize / (1024.0 * 1024.0));
+    }
+
+    for (size_t i = 0; i < sizeof(FILTER_EXPRESSIONS) / sizeof(FILTER_EXPRESSIONS[0]) && result == 0; i++) {
+        LogFilter filter = { 0 };
+        LogFilter_Compile(&filter, &table, FILTER_EXPRESSIONS[i]);
+
+        BenchResult filterResult = { .unit = "rows/s", .higherIsBetter = 1 };
+        snprintf(filterResult.name, sizeof(filterResult.name), "filter %s", FILTER_EXPRESSIONS[i]);
+        BenchJob job = { .kind = BENCH_FILTER, .table = &table, .filter = &filter, .rows = rows };
+        result |= Measure(&filterResult, &job, runCount, table.rowCount);
+        LogFilter_Free(&filter);
+    }
+
+    for (size_t i = 0; i < sizeof(GROUP_BY_COLUMNS) / sizeof(GROUP_BY_COLUMNS[0]) && result == 0; i++) {
+        int column = LogTable_FindColumn(&table, GROUP_BY_COLUMNS[i]);
+
+        if (column < 0) {
+            continue;
+        }
+
+        BenchResult groupBy = { .unit = "ms", .higherIsBetter = 0 };
+        snprintf(groupBy.name, sizeof(groupBy.name), "group-by %s", GROUP_BY_COLUMNS[i]);
+        BenchJob job = { .kind = BENCH_GROUP_BY, .table = &table, .column = column };
+        result |= Measure(&groupBy, &job, runCount, 0);
+    }
+
+    // Sessions sort every row by client and time, in parallel.
+    if (result == 0 && table.clientIpColumn >= 0) {
+        BenchResult sessions = { .name = "sessions", .unit = "ms", .higherIsBetter = 0 };
+        BenchJob job = { .kind = BENCH_SESSIONS, .table = &table };
+        result |= Measure(&sessions, &job, runCount, 0);
+    }
+
+    if (result != 0) {
+        fprintf(stderr, "A benchmark failed on '%s'\n", argv[1]);
+    }
+
+    free(rows);
+    LogTable_Free(&table);
+
+    return result;
+}
@@ -0,0 +1,232 @@
+#define CLAY_IMPLEMENTATION
+#include "include/clay.h"
+#include "table_layout.h"
+#include "benchmarks/bench_report.h"
+
+#define LAYOUT_COLUMN_COUNT 6
+#define LAYOUT_GRID_COLUMN_COUNT 15
+#define LAYOUT_WIDTH 1600
+#define LAYOUT_HEIGHT 900
+#define LAYOUT_MIN_RUN_SECONDS 0.2
+// The session line the pointer is put over, to check hovering reaches the right one, with the
+// sessions scrolled down to LAYOUT_SCROLLED_ROW.
+#define LAYOUT_HOVERED_ROW 3
+#define LAYOUT_SCROLLED_ROW 1000
+
+// Lines of the grouped views. Only the ones in view are declared, the last is about the sessions
+// of a 64 MB log.
+static const int LINE_COUNTS[] = { 10, 50, 100, 500, 2000, 30000 };
+static const int GRID_ROW_COUNTS[] = { 18, 60 };
+
+static const Clay_String SAMPLE_HEADERS[LAYOUT_COLUMN_COUNT] = {
+    CLAY_STRING_CONST("route"), CLAY_STRING_CONST("requests"), CLAY_STRING_CONST("errors %"),
+    CLAY_STRING_CONST("p50 ms"), CLAY_STRING_CONST("p95 ms"), CLAY_STRING_CONST("p99 ms")
+};
+static const Clay_String SAMPLE_CELLS[LAYOUT_COLUMN_COUNT] = {
+    CLAY_STRING_CONST("/api/orders/{id}"), CLAY_STRING_CONST("231305"), CLAY_STRING_CONST("2.47"),
+    CLAY_STRING_CONST("14"), CLAY_STRING_CONST("92"), CLAY_STRING_CONST("210")
+};
+static const Clay_String GRID_HEADERS[LAYOUT_GRID_COLUMN_COUNT] = {
+    CLAY_STRING_CONST("date"), CLAY_STRING_CONST("time"), CLAY_STRING_CONST("s-ip"), CLAY_STRING_CONST("cs-method"),
+    CLAY_STRING_CONST("cs-uri-stem"), CLAY_STRING_CONST("cs-uri-query"), CLAY_STRING_CONST("s-port"),
+    CLAY_STRING_CONST("cs-username"), CLAY_STRING_CONST("c-ip"), CLAY_STRING_CONST("cs(User-Agent)"),
+    CLAY_STRING_CONST("cs(Referer)"), CLAY_STRING_CONST("sc-status"), CLAY_STRING_CONST("sc-substatus"),
+    CLAY_STRING_CONST("sc-win32-status"), CLAY_STRING_CONST("time-taken")
+};
+
+typedef struct {
+    const char* name;
+    TableLayout table;
+    // Elements the layout has to come out with, a change means the tree of main.c changed shape.
+    int32_t expectedElements;
+} LayoutCase;
+
+static int hoveredRow = -1;
+static int clayErrorCount = 0;
+
+// Average glyph width at half the font size, no font or GPU needed.
+static Clay_Dimensions MeasureText(Clay_StringSlice text, Clay_TextElementConfig* config, void* userData) {
+    (void)userData;
+    return (Clay_Dimensions) { .width = text.length * config->fontSize * 0.5f, .height = config->fontSize };
+}
+
+static void HandleClayErrors(Clay_ErrorData errorData) {
+    clayErrorCount++;
+    fprintf(stderr, "%.*s\n", (int)errorData.errorText.length, errorData.errorText.chars);
+}
+
+static void HandleRowHover(Clay_ElementId elementId, Clay_PointerData pointerData, intptr_t row) {
+    (void)elementId;
+    (void)pointerData;
+    hoveredRow = (int)row;
+}
+
+// The same window the viewer lays its table out in, minus the search bar and info around it.
+static Clay_RenderCommandArray LayoutTable(const TableLayout* table) {
+    Clay_BeginLayout();
+    TableLayout_Declare(table);
+    return Clay_EndLayout();
+}
+
+// Root, Table, TableHeader with a container and text per column, and TableLines.
+static int32_t ExpectedElements(int columnCount, int lineElements) {
+    return 4 + 2 * columnCount + lineElements;
+}
+
+// The lines of a grouped view the viewer declares when scrolled to the scroll, against the whole
+// window since there's no earlier layout to size the lines area from.
+static void SliceLines(TableLayout* table, const TableScroll* scroll, uint64_t lineCount) {
+    table->firstRow = scroll->firstRow;
+    table->rowCount = TableScroll_CountVisibleRows(scroll, lineCount, LAYOUT_HEIGHT);
+}
+
+// Milliseconds one layout of the case takes, averaged over as many as fit in LAYOUT_MIN_RUN_SECONDS.
+static double TimeLayout(const TableLayout* table) {
+    double start = Bench_Seconds();
+    double elapsed = 0;
+    int layoutCount = 0;
+
+    while (elapsed < LAYOUT_MIN_RUN_SECONDS) {
+        LayoutTable(table);
+        layoutCount++;
+        elapsed = Bench_Seconds() - start;
+    }
+
+    return elapsed * 1000 / layoutCount;
+}
+
+// Prints the layout time and element count of the case, returns 0 if the count is the expected one and
+// fits the viewer's element cap.
+static int MeasureCase(const LayoutCase* layoutCase, int runCount) {
+    int errorCount = clayErrorCount;
+    BenchResult time = { .unit = "ms", .higherIsBetter = 0, .runCount = runCount };
+    BenchResult elements = { .unit = "elements", .higherIsBetter = 0, .runCount = 1 };
+    snprintf(time.name, sizeof(time.name), "layout %s", layoutCase->name);
+    snprintf(elements.name, sizeof(elements.name), "elements %s", layoutCase->name);
+
+    for (int run = 0; run < runCount; run++) {
+        time.runs[run] = TimeLayout(&layoutCase->table);
+    }
+
+    int32_t elementCount = Clay_GetCurrentContext()->layoutElements.length;
+    elements.runs[0] = elementCount;
+
+    Bench_Print(&time);
+    Bench_Print(&elements);
+
+    if (clayErrorCount > errorCount || elementCount > TABLE_LAYOUT_MAX_ELEMENTS) {
+        fprintf(stderr, "%s: needs more than the viewer's %d elements\n", layoutCase->name, TABLE_LAYOUT_MAX_ELEMENTS);
+        return 1;
+    }
+
+    if (elementCount != layoutCase->expectedElements) {
+        fprintf(stderr, "%s: laid out %d elements, expected %d\n", layoutCase->name, elementCount, layoutCase->expectedElements);
+        return 1;
+    }
+
+    return 0;
+}
+
+// Puts the pointer over a session line and checks its hover handler gets that line, counted from the first
+// session rather than the first line in view. As in the viewer, Clay calls the handlers while setting the
+// pointer, against the last layout.
+static int CheckHover(const TableLayout* table) {
+    float y = CELL_PADDING * 2 + FONT_SIZE + LAYOUT_HOVERED_ROW * ROW_HEIGHT + ROW_HEIGHT / 2;
+    LayoutTable(table);
+    hoveredRow = -1;
+    Clay_SetPointerState((Clay_Vector2) { LAYOUT_WIDTH / 2, y }, false);
+    Clay_SetPointerState((Clay_Vector2) { -1, -1 }, false);
+
+    if (hoveredRow != (int)table->firstRow + LAYOUT_HOVERED_ROW) {
+        fprintf(stderr, "sessions: hovering line %d reported %d\n", (int)table->firstRow + LAYOUT_HOVERED_ROW, hoveredRow);
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int runCount = Bench_ParseRuns(&argc, argv);
+
+    if (argc != 1) {
+        printf("Usage: %s [--runs <n>]\n"
+               "Clay layout time and element count of the viewer's table without a window, one JSON object per line.\n"
+               "Exits with 1 when an element count or hover check doesn't match the table of the viewer.\n", argv[0]);
+        return 1;
+    }
+
+    int maxRowCount = LINE_COUNTS[sizeof(LINE_COUNTS) / sizeof(LINE_COUNTS[0]) - 1];
+    Clay_String* cells = malloc((size_t)maxRowCount * LAYOUT_COLUMN_COUNT * sizeof(Clay_String));
+    float gridWidths[LAYOUT_GRID_COLUMN_COUNT];
+
+    for (int i = 0; i < maxRowCount * LAYOUT_COLUMN_COUNT; i++) {
+        cells[i] = SAMPLE_CELLS[i % LAYOUT_COLUMN_COUNT];
+    }
+
+    for (int column = 0; column < LAYOUT_GRID_COLUMN_COUNT; column++) {
+        gridWidths[column] = MIN_COLUMN_WIDTH + (column % 4) * 60;
+    }
+
+    Clay_SetMaxElementCount(TABLE_LAYOUT_MAX_ELEMENTS);
+    uint64_t memorySize = Clay_MinMemorySize();
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(memorySize, malloc(memorySize));
+    Clay_Initialize(arena, (Clay_Dimensions) { LAYOUT_WIDTH, LAYOUT_HEIGHT }, (Clay_ErrorHandler) { HandleClayErrors, 0 });
+    Clay_SetMeasureTextFunction(MeasureText, 0);
+
+    int result = 0;
+    char names[sizeof(LINE_COUNTS) / sizeof(LINE_COUNTS[0]) + sizeof(GRID_ROW_COUNTS) / sizeof(GRID_ROW_COUNTS[0])][32];
+    int nameCount = 0;
+
+    // The grouped views lay out the lines in view, so their cost stops growing once the lines fill the window.
+    TableScroll top = { 0 };
+
+    for (size_t i = 0; i < sizeof(LINE_COUNTS) / sizeof(LINE_COUNTS[0]); i++) {
+        snprintf(names[nameCount], sizeof(names[nameCount]), "%d rows", LINE_COUNTS[i]);
+
+        LayoutCase layoutCase = {
+            .name = names[nameCount++],
+            .table = { .headers = SAMPLE_HEADERS, .columnCount = LAYOUT_COLUMN_COUNT, .cells = cells }
+        };
+        SliceLines(&layoutCase.table, &top, LINE_COUNTS[i]);
+        layoutCase.expectedElements = ExpectedElements(LAYOUT_COLUMN_COUNT, layoutCase.table.rowCount * (1 + 2 * LAYOUT_COLUMN_COUNT));
+        result |= MeasureCase(&layoutCase, runCount);
+    }
+
+    // Sessions are the grouped view with a hover handler on every line, here scrolled down a long way.
+    TableScroll scrolled = { 0 };
+    TableScroll_JumpTo(&scrolled, LAYOUT_SCROLLED_ROW, maxRowCount, LAYOUT_HEIGHT);
+
+    LayoutCase sessions = {
+        .name = "sessions scrolled",
+        .table = { .headers = SAMPLE_HEADERS, .columnCount = LAYOUT_COLUMN_COUNT, .cells = cells, .onRowHover = HandleRowHover }
+    };
+    SliceLines(&sessions.table, &scrolled, maxRowCount);
+    sessions.expectedElements = ExpectedElements(LAYOUT_COLUMN_COUNT, sessions.table.rowCount * (1 + 2 * LAYOUT_COLUMN_COUNT));
+    result |= MeasureCase(&sessions, runCount);
+    result |= CheckHover(&sessions.table);
+
+    // The rows view is a single custom element whatever the row count, only its header grows with the columns.
+    for (size_t i = 0; i < sizeof(GRID_ROW_COUNTS) / sizeof(GRID_ROW_COUNTS[0]); i++) {
+        snprintf(names[nameCount], sizeof(names[nameCount]), "grid %d rows", GRID_ROW_COUNTS[i]);
+
+        LayoutCase grid = {
+            .name = names[nameCount++],
+            .table = {
+                .headers = GRID_HEADERS,
+                .columnCount = LAYOUT_GRID_COLUMN_COUNT,
+                // Nothing draws it here, any data makes it the rows view.
+                .gridData = gridWidths,
+                .columnWidths = gridWidths,
+                .gridWidth = LAYOUT_WIDTH * 2,
+                .gridHeight = (float)GRID_ROW_COUNTS[i] * ROW_HEIGHT
+            },
+            .expectedElements = ExpectedElements(LAYOUT_GRID_COLUMN_COUNT, 1)
+        };
+        result |= MeasureCase(&grid, runCount);
+    }
+
+    free(arena.memory);
+    free(cells);
+
+    return result;
+}
@@ -0,0 +1,91 @@
+#ifndef IIS_BENCH_REPORT_H
+#define IIS_BENCH_REPORT_H
+
+#include "engine/log_profile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_MAX_RUNS 64
+#define BENCH_DEFAULT_RUNS 5
+
+// One measurement repeated runCount times. Every benchmark prints its results as NDJSON lines:
+//   {"benchmark":"parse","unit":"MB/s","better":"higher","median":812.4,"runs":[...]}
+// so runs on different commits or machines can be compared line by line.
+typedef struct {
+    char name[64];
+    const char* unit;
+    // Whether a larger value is an improvement, like throughput, or a regression, like latency.
+    int higherIsBetter;
+    double runs[BENCH_MAX_RUNS];
+    int runCount;
+} BenchResult;
+
+static inline double Bench_Seconds(void) {
+    return LogProfile_Now() / 1000000.0;
+}
+
+// Reads --runs <n> out of the arguments, leaving the rest in place, for the benchmarks to share.
+static inline int Bench_ParseRuns(int* argc, char** argv) {
+    int runs = BENCH_DEFAULT_RUNS;
+
+    for (int i = 1; i + 1 < *argc; i++) {
+        if (strcmp(argv[i], "--runs") == 0) {
+            runs = atoi(argv[i + 1]);
+            runs = runs < 1 ? 1 : runs > BENCH_MAX_RUNS ? BENCH_MAX_RUNS : runs;
+            memmove(argv + i, argv + i + 2, (*argc - i - 2) * sizeof(char*));
+            *argc -= 2;
+            break;
+        }
+    }
+
+    return runs;
+}
+
+static inline int Bench_CompareDoubles(const void* a, const void* b) {
+    double left = *(const double*)a;
+    double right = *(const double*)b;
+
+    return (left > right) - (left < right);
+}
+
+static inline double Bench_Median(const double* values, int count) {
+    double sorted[BENCH_MAX_RUNS];
+    memcpy(sorted, values, count * sizeof(double));
+    qsort(sorted, count, sizeof(double), Bench_CompareDoubles);
+
+    return count % 2 == 1 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+}
+
+// Median absolute deviation from the median: how much the runs spread, without one slow run taking over.
+static inline double Bench_Mad(const double* values, int count) {
+    double median = Bench_Median(values, count);
+    double deviations[BENCH_MAX_RUNS];
+
+    for (int i = 0; i < count; i++) {
+        deviations[i] = values[i] > median ? values[i] - median : median - values[i];
+    }
+
+    return Bench_Median(deviations, count);
+}
+
+static inline void Bench_Print(const BenchResult* result) {
+    printf("{\"benchmark\":\"");
+
+    // Names can quote a filter expression, which can have backslashes.
+    for (const char* c = result->name; *c != '\0'; c++) {
+        printf(*c == '"' || *c == '\\' ? "\\%c" : "%c", *c);
+    }
+
+    printf("\",\"unit\":\"%s\",\"better\":\"%s\",\"median\":%.6g,\"runs\":[", result->unit,
+           result->higherIsBetter ? "higher" : "lower", Bench_Median(result->runs, result->runCount));
+
+    for (int i = 0; i < result->runCount; i++) {
+        printf("%s%.6g", i > 0 ? "," : "", result->runs[i]);
+    }
+
+    printf("]}\n");
+    fflush(stdout);
+}
+
+#endif
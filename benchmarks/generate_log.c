@@ -0,0 +1,575 @@
+#ifndef _WIN32
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#define GENERATE_MIN_SIZE (1ull << 20)
+#define GENERATE_MAX_SIZE (20ull << 30)
+#define GENERATE_DEFAULT_SIZE (64ull << 20)
+#define GENERATE_BUFFER_SIZE (4 << 20)
+#define GENERATE_LINE_LIMIT 4096
+#define CLIENT_COUNT 50000
+#define URI_COUNT 4000
+#define USER_COUNT 200
+// Rows start here and move forward a few milliseconds each, about 150 requests a second.
+#define GENERATE_START_TIMESTAMP 1714521600ll
+#define MEAN_ROW_INTERVAL_MS 7
+
+typedef enum {
+    FIELD_DATE,
+    FIELD_TIME,
+    FIELD_SITE_NAME,
+    FIELD_COMPUTER_NAME,
+    FIELD_SERVER_IP,
+    FIELD_METHOD,
+    FIELD_URI_STEM,
+    FIELD_URI_QUERY,
+    FIELD_SERVER_PORT,
+    FIELD_USERNAME,
+    FIELD_CLIENT_IP,
+    FIELD_VERSION,
+    FIELD_USER_AGENT,
+    FIELD_COOKIE,
+    FIELD_REFERER,
+    FIELD_HOST,
+    FIELD_STATUS,
+    FIELD_SUBSTATUS,
+    FIELD_WIN32_STATUS,
+    FIELD_BYTES_SENT,
+    FIELD_BYTES_RECEIVED,
+    FIELD_TIME_TAKEN,
+    FIELD_COUNT
+} Field;
+
+static const char* FIELD_NAMES[FIELD_COUNT] = {
+    "date", "time", "s-sitename", "s-computername", "s-ip", "cs-method", "cs-uri-stem", "cs-uri-query", "s-port",
+    "cs-username", "c-ip", "cs-version", "cs(UserAgent)", "cs(Cookie)", "cs(Referer)", "cs-host", "sc-status",
+    "sc-substatus", "sc-win32-status", "sc-bytes", "cs-bytes", "time-taken"
+};
+
+// The #Fields lists a restart can switch to: what IIS logs by default, everything, and a short one.
+static const Field DEFAULT_FIELDS[] = {
+    FIELD_DATE, FIELD_TIME, FIELD_SERVER_IP, FIELD_METHOD, FIELD_URI_STEM, FIELD_URI_QUERY, FIELD_SERVER_PORT, FIELD_USERNAME,
+    FIELD_CLIENT_IP, FIELD_USER_AGENT, FIELD_REFERER, FIELD_STATUS, FIELD_SUBSTATUS, FIELD_WIN32_STATUS, FIELD_TIME_TAKEN
+};
+static const Field EXTENDED_FIELDS[] = {
+    FIELD_DATE, FIELD_TIME, FIELD_SITE_NAME, FIELD_COMPUTER_NAME, FIELD_SERVER_IP, FIELD_METHOD, FIELD_URI_STEM, FIELD_URI_QUERY,
+    FIELD_SERVER_PORT, FIELD_USERNAME, FIELD_CLIENT_IP, FIELD_VERSION, FIELD_USER_AGENT, FIELD_COOKIE, FIELD_REFERER, FIELD_HOST,
+    FIELD_STATUS, FIELD_SUBSTATUS, FIELD_WIN32_STATUS, FIELD_BYTES_SENT, FIELD_BYTES_RECEIVED, FIELD_TIME_TAKEN
+};
+static const Field SHORT_FIELDS[] = {
+    FIELD_DATE, FIELD_TIME, FIELD_CLIENT_IP, FIELD_METHOD, FIELD_URI_STEM, FIELD_STATUS, FIELD_TIME_TAKEN
+};
+
+typedef struct {
+    const Field* fields;
+    int fieldCount;
+} FieldList;
+
+static const FieldList FIELD_LISTS[] = {
+    { DEFAULT_FIELDS, sizeof(DEFAULT_FIELDS) / sizeof(DEFAULT_FIELDS[0]) },
+    { EXTENDED_FIELDS, sizeof(EXTENDED_FIELDS) / sizeof(EXTENDED_FIELDS[0]) },
+    { SHORT_FIELDS, sizeof(SHORT_FIELDS) / sizeof(SHORT_FIELDS[0]) }
+};
+
+static const char* URI_TEMPLATES[] = {
+    "/api/orders/%u", "/api/customers/%u/invoices", "/api/v2/products/%u", "/images/products/%u.jpg",
+    "/static/js/app.%08x.js", "/static/css/site.%08x.css", "/blog/%u/comments", "/api/search"
+};
+
+// A few paths every site gets, put in front of the generated ones so they're the most requested.
+static const char* COMMON_URIS[] = {
+    "/", "/favicon.ico", "/api/health", "/login", "/robots.txt", "/wp-login.php", "/.env", "/admin/config.php"
+};
+
+static const char* USER_AGENTS[] = {
+    "Mozilla/5.0+(Windows+NT+10.0;+Win64;+x64)+AppleWebKit/537.36+(KHTML,+like+Gecko)+Chrome/124.0.0.0+Safari/537.36",
+    "Mozilla/5.0+(Macintosh;+Intel+Mac+OS+X+10_15_7)+AppleWebKit/605.1.15+(KHTML,+like+Gecko)+Version/17.4+Safari/605.1.15",
+    "Mozilla/5.0+(iPhone;+CPU+iPhone+OS+17_4+like+Mac+OS+X)+AppleWebKit/605.1.15+(KHTML,+like+Gecko)+Version/17.4+Mobile/15E148+Safari/604.1",
+    "Mozilla/5.0+(Windows+NT+10.0;+Win64;+x64;+rv:125.0)+Gecko/20100101+Firefox/125.0",
+    "Mozilla/5.0+(Linux;+Android+14;+Pixel+8)+AppleWebKit/537.36+(KHTML,+like+Gecko)+Chrome/124.0.6367.82+Mobile+Safari/537.36",
+    "curl/8.4.0",
+    "Go-http-client/1.1",
+    "python-requests/2.31.0",
+    "Mozilla/5.0+(compatible;+Googlebot/2.1;++http://www.google.com/bot.html)",
+    "Mozilla/5.0+(compatible;+bingbot/2.0;++http://www.bing.com/bingbot.htm)",
+    "sqlmap/1.7.2#stable+(https://sqlmap.org)",
+    "Mozilla/5.0+(Windows+NT+10.0;+WOW64;+Trident/7.0;+.NET4.0C;+.NET4.0E;+.NET+CLR+2.0.50727;+.NET+CLR+3.0.30729;+.NET+CLR+3.5.30729;"
+    "+InfoPath.3;+Tablet+PC+2.0;+MSOffice+16;+Microsoft+Outlook+16.0.17328;+ms-office;+MSOffice+16)+like+Gecko+"
+    "Mozilla/5.0+(Windows+NT+10.0;+Win64;+x64)+AppleWebKit/537.36+(KHTML,+like+Gecko)+Chrome/124.0.0.0+Safari/537.36+Edg/124.0.2478.80+"
+    "OneDriveSync/24.076.0414.0003+Teams/24102.2223.2870.9480+Electron/29.1.0+(Windows+NT+10.0;+Win64;+x64)+WebView2/124.0.2478.80",
+    "Mozilla/5.0+(Linux;+Android+10;+K)+AppleWebKit/537.36+(KHTML,+like+Gecko)+Chrome/124.0.0.0+Mobile+Safari/537.36+"
+    "[FBAN/FB4A;FBAV/460.0.0.48.109;FBBV/584425917;FBDM/{density=2.625,width=1080,height=2209};FBLC/en_US;FBRV/0;FBCR/T-Mobile;"
+    "FBMF/samsung;FBBD/samsung;FBPN/com.facebook.katana;FBDV/SM-S918U;FBSV/14;FBOP/1;FBCA/arm64-v8a:;]"
+};
+
+typedef struct {
+    uint16_t status;
+    uint16_t substatus;
+    uint16_t win32Status;
+    // Out of 1000.
+    uint16_t weight;
+} StatusWeight;
+
+static const StatusWeight STATUS_WEIGHTS[] = {
+    { 200, 0, 0, 780 }, { 304, 0, 0, 70 }, { 302, 0, 0, 30 }, { 301, 0, 0, 10 }, { 404, 0, 2, 60 },
+    { 401, 1, 5, 20 }, { 403, 14, 0, 5 }, { 500, 0, 64, 15 }, { 500, 19, 13, 3 }, { 503, 0, 0, 7 }
+};
+
+typedef struct {
+    uint64_t state;
+} Random;
+
+// xorshift64*, plenty for test data and the same everywhere for a given seed.
+static uint64_t Random_Next(Random* random) {
+    random->state ^= random->state >> 12;
+    random->state ^= random->state << 25;
+    random->state ^= random->state >> 27;
+    return random->state * 0x2545F4914F6CDD1Dull;
+}
+
+static double Random_Unit(Random* random) {
+    return (double)(Random_Next(random) >> 11) / 9007199254740992.0;
+}
+
+static uint32_t Random_Below(Random* random, uint32_t limit) {
+    return (uint32_t)(Random_Unit(random) * limit);
+}
+
+// A Zipf distribution over count items, item 0 the most likely, sampled by binary search of its CDF.
+typedef struct {
+    double* cumulative;
+    uint32_t count;
+} Zipf;
+
+static int Zipf_Init(Zipf* zipf, uint32_t count, double exponent) {
+    zipf->count = count;
+    zipf->cumulative = malloc(count * sizeof(double));
+
+    if (zipf->cumulative == 0) {
+        return 1;
+    }
+
+    double total = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        total += 1.0 / pow(i + 1, exponent);
+        zipf->cumulative[i] = total;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        zipf->cumulative[i] /= total;
+    }
+
+    return 0;
+}
+
+static uint32_t Zipf_Sample(const Zipf* zipf, Random* random) {
+    double value = Random_Unit(random);
+    uint32_t low = 0;
+    uint32_t high = zipf->count - 1;
+
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+
+        if (zipf->cumulative[middle] < value) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+typedef struct {
+    char* data;
+    size_t used;
+    FILE* file;
+    uint64_t written;
+    int failed;
+} Output;
+
+static void Output_Flush(Output* output) {
+    if (output->used > 0 && !output->failed && fwrite(output->data, 1, output->used, output->file) != output->used) {
+        output->failed = 1;
+    }
+
+    output->written += output->used;
+    output->used = 0;
+}
+
+static void Output_Append(Output* output, const char* text, size_t length) {
+    memcpy(output->data + output->used, text, length);
+    output->used += length;
+}
+
+static void Output_AppendString(Output* output, const char* text) {
+    Output_Append(output, text, strlen(text));
+}
+
+static void Output_AppendNumber(Output* output, uint64_t value) {
+    char digits[20];
+    int count = 0;
+
+    do {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    while (count > 0) {
+        output->data[output->used++] = digits[--count];
+    }
+}
+
+static void Output_AppendPadded(Output* output, uint32_t value, int width) {
+    for (int i = width - 1; i >= 0; i--) {
+        output->data[output->used + i] = (char)('0' + value % 10);
+        value /= 10;
+    }
+
+    output->used += width;
+}
+
+static void CivilFromDays(int64_t days, int64_t* year, int64_t* month, int64_t* day) {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    int64_t dayOfEra = days - era * 146097;
+    int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int64_t monthIndex = (5 * dayOfYear + 2) / 153;
+
+    *day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    *month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    *year = yearOfEra + era * 400 + (*month <= 2);
+}
+
+static void Output_AppendDate(Output* output, int64_t timestamp) {
+    int64_t year;
+    int64_t month;
+    int64_t day;
+    CivilFromDays(timestamp / 86400, &year, &month, &day);
+
+    Output_AppendPadded(output, (uint32_t)year, 4);
+    Output_Append(output, "-", 1);
+    Output_AppendPadded(output, (uint32_t)month, 2);
+    Output_Append(output, "-", 1);
+    Output_AppendPadded(output, (uint32_t)day, 2);
+}
+
+static void Output_AppendTime(Output* output, int64_t timestamp) {
+    int64_t seconds = timestamp % 86400;
+
+    Output_AppendPadded(output, (uint32_t)(seconds / 3600), 2);
+    Output_Append(output, ":", 1);
+    Output_AppendPadded(output, (uint32_t)(seconds / 60 % 60), 2);
+    Output_Append(output, ":", 1);
+    Output_AppendPadded(output, (uint32_t)(seconds % 60), 2);
+}
+
+typedef struct {
+    char text[48];
+    uint8_t userAgent;
+    uint16_t user;
+} Client;
+
+typedef struct {
+    Random random;
+    Client* clients;
+    char (*uris)[64];
+    Zipf clientZipf;
+    Zipf uriZipf;
+    Zipf userAgentZipf;
+    // Milliseconds since GENERATE_START_TIMESTAMP.
+    uint64_t clock;
+} Generator;
+
+static int Generator_Init(Generator* generator, uint64_t seed) {
+    memset(generator, 0, sizeof(*generator));
+    // Zero would get xorshift stuck, any other seed is fine as it is.
+    generator->random.state = seed * 0x9E3779B97F4A7C15ull + 1;
+    generator->clients = malloc(CLIENT_COUNT * sizeof(Client));
+    generator->uris = malloc(URI_COUNT * sizeof(*generator->uris));
+
+    if (generator->clients == 0 || generator->uris == 0 || Zipf_Init(&generator->clientZipf, CLIENT_COUNT, 1.1) != 0 ||
+        Zipf_Init(&generator->uriZipf, URI_COUNT, 1.2) != 0 ||
+        Zipf_Init(&generator->userAgentZipf, sizeof(USER_AGENTS) / sizeof(USER_AGENTS[0]), 0.9) != 0) {
+        return 1;
+    }
+
+    Random* random = &generator->random;
+
+    // About one client in ten comes over IPv6, the rest from a handful of private and public ranges.
+    for (uint32_t i = 0; i < CLIENT_COUNT; i++) {
+        Client* client = &generator->clients[i];
+
+        if (Random_Below(random, 10) == 0) {
+            snprintf(client->text, sizeof(client->text), "2001:db8:%x:%x::%x", Random_Below(random, 64), Random_Below(random, 65536), Random_Below(random, 65536));
+        } else {
+            static const uint32_t FIRST_OCTETS[] = { 10, 192, 172, 52, 81, 203 };
+            uint32_t firstOctet = FIRST_OCTETS[Random_Below(random, sizeof(FIRST_OCTETS) / sizeof(FIRST_OCTETS[0]))];
+            snprintf(client->text, sizeof(client->text), "%u.%u.%u.%u", firstOctet, Random_Below(random, 256), Random_Below(random, 256), 1 + Random_Below(random, 254));
+        }
+
+        client->userAgent = (uint8_t)Zipf_Sample(&generator->userAgentZipf, random);
+        client->user = Random_Below(random, 4) == 0 ? (uint16_t)(1 + Random_Below(random, USER_COUNT)) : 0;
+    }
+
+    int commonCount = sizeof(COMMON_URIS) / sizeof(COMMON_URIS[0]);
+    int templateCount = sizeof(URI_TEMPLATES) / sizeof(URI_TEMPLATES[0]);
+
+    for (uint32_t i = 0; i < URI_COUNT; i++) {
+        if (i < (uint32_t)commonCount) {
+            snprintf(generator->uris[i], sizeof(generator->uris[i]), "%s", COMMON_URIS[i]);
+        } else {
+            const char* uriTemplate = URI_TEMPLATES[Random_Below(random, templateCount)];
+            snprintf(generator->uris[i], sizeof(generator->uris[i]), uriTemplate, (unsigned)(Random_Next(random) % 1000000));
+        }
+    }
+
+    return 0;
+}
+
+static void Generator_Free(Generator* generator) {
+    free(generator->clients);
+    free(generator->uris);
+    free(generator->clientZipf.cumulative);
+    free(generator->uriZipf.cumulative);
+    free(generator->userAgentZipf.cumulative);
+}
+
+static void WriteDirectives(Generator* generator, Output* output, const FieldList* fieldList) {
+    int64_t timestamp = GENERATE_START_TIMESTAMP + (int64_t)(generator->clock / 1000);
+
+    Output_AppendString(output, "#Software: Microsoft Internet Information Services 10.0\n#Version: 1.0\n#Date: ");
+    Output_AppendDate(output, timestamp);
+    Output_Append(output, " ", 1);
+    Output_AppendTime(output, timestamp);
+    Output_AppendString(output, "\n#Fields:");
+
+    for (int i = 0; i < fieldList->fieldCount; i++) {
+        Output_Append(output, " ", 1);
+        Output_AppendString(output, FIELD_NAMES[fieldList->fields[i]]);
+    }
+
+    Output_Append(output, "\n", 1);
+}
+
+static void WriteRow(Generator* generator, Output* output, const FieldList* fieldList) {
+    Random* random = &generator->random;
+    // Gaps between requests are exponential, so there are bursts as well as quiet stretches.
+    generator->clock += (uint64_t)(-log(1.0 - Random_Unit(random)) * MEAN_ROW_INTERVAL_MS);
+
+    int64_t timestamp = GENERATE_START_TIMESTAMP + (int64_t)(generator->clock / 1000);
+    const Client* client = &generator->clients[Zipf_Sample(&generator->clientZipf, random)];
+    uint32_t uriIndex = Zipf_Sample(&generator->uriZipf, random);
+    const char* uri = generator->uris[uriIndex];
+    uint32_t statusRoll = Random_Below(random, 1000);
+    const StatusWeight* status = &STATUS_WEIGHTS[0];
+
+    for (size_t i = 0; i < sizeof(STATUS_WEIGHTS) / sizeof(STATUS_WEIGHTS[0]); i++) {
+        if (statusRoll < STATUS_WEIGHTS[i].weight) {
+            status = &STATUS_WEIGHTS[i];
+            break;
+        }
+
+        statusRoll -= STATUS_WEIGHTS[i].weight;
+    }
+
+    uint32_t methodRoll = Random_Below(random, 100);
+    const char* method = methodRoll < 84 ? "GET" : methodRoll < 96 ? "POST" : methodRoll < 98 ? "HEAD" : methodRoll < 99 ? "PUT" : "DELETE";
+    // Log-normal time-taken with the odd request stuck for seconds.
+    double timeTaken = exp(2.7 + 1.1 * sqrt(-2.0 * log(1.0 - Random_Unit(random))) * cos(6.283185307179586 * Random_Unit(random)));
+
+    if (Random_Below(random, 500) == 0) {
+        timeTaken *= 200;
+    }
+
+    for (int i = 0; i < fieldList->fieldCount; i++) {
+        if (i > 0) {
+            Output_Append(output, " ", 1);
+        }
+
+        switch (fieldList->fields[i]) {
+            case FIELD_DATE: Output_AppendDate(output, timestamp); break;
+            case FIELD_TIME: Output_AppendTime(output, timestamp); break;
+            case FIELD_SITE_NAME: Output_AppendString(output, "W3SVC1"); break;
+            case FIELD_COMPUTER_NAME: Output_AppendString(output, "WEB01"); break;
+            case FIELD_SERVER_IP: Output_AppendString(output, "10.0.0.4"); break;
+            case FIELD_METHOD: Output_AppendString(output, method); break;
+            case FIELD_URI_STEM: Output_AppendString(output, uri); break;
+            case FIELD_URI_QUERY:
+                if (strcmp(uri, "/api/search") == 0) {
+                    Output_AppendString(output, "q=item");
+                    Output_AppendNumber(output, Random_Below(random, 5000));
+                    Output_AppendString(output, "&page=");
+                    Output_AppendNumber(output, 1 + Random_Below(random, 20));
+                } else {
+                    Output_Append(output, "-", 1);
+                }
+                break;
+            case FIELD_SERVER_PORT: Output_AppendString(output, uriIndex % 7 == 0 ? "80" : "443"); break;
+            case FIELD_USERNAME:
+                if (client->user != 0) {
+                    Output_AppendString(output, "CONTOSO\\user");
+                    Output_AppendNumber(output, client->user);
+                } else {
+                    Output_Append(output, "-", 1);
+                }
+                break;
+            case FIELD_CLIENT_IP: Output_AppendString(output, client->text); break;
+            case FIELD_VERSION: Output_AppendString(output, "HTTP/1.1"); break;
+            case FIELD_USER_AGENT: Output_AppendString(output, USER_AGENTS[client->userAgent]); break;
+            case FIELD_COOKIE:
+                if (client->user != 0) {
+                    Output_AppendString(output, "ASP.NET_SessionId=");
+                    Output_AppendNumber(output, Random_Next(random) % 1000000000000ull);
+                } else {
+                    Output_Append(output, "-", 1);
+                }
+                break;
+            case FIELD_REFERER:
+                if (Random_Below(random, 3) == 0) {
+                    Output_AppendString(output, "https://www.contoso.com");
+                    Output_AppendString(output, generator->uris[Zipf_Sample(&generator->uriZipf, random)]);
+                } else {
+                    Output_Append(output, "-", 1);
+                }
+                break;
+            case FIELD_HOST: Output_AppendString(output, "www.contoso.com"); break;
+            case FIELD_STATUS: Output_AppendNumber(output, status->status); break;
+            case FIELD_SUBSTATUS: Output_AppendNumber(output, status->substatus); break;
+            case FIELD_WIN32_STATUS: Output_AppendNumber(output, status->win32Status); break;
+            case FIELD_BYTES_SENT: Output_AppendNumber(output, status->status == 304 ? 143 : 200 + Random_Below(random, 60000)); break;
+            case FIELD_BYTES_RECEIVED: Output_AppendNumber(output, 300 + Random_Below(random, 1500)); break;
+            case FIELD_TIME_TAKEN: Output_AppendNumber(output, (uint64_t)timeTaken); break;
+            case FIELD_COUNT: break;
+        }
+    }
+
+    Output_Append(output, "\n", 1);
+}
+
+// Reads a byte count with an optional K, M or G suffix, 0 when it isn't one.
+static uint64_t ParseSize(const char* text) {
+    char* end;
+    uint64_t size = strtoull(text, &end, 10);
+
+    switch (*end) {
+        case 'K': case 'k': size <<= 10; end++; break;
+        case 'M': case 'm': size <<= 20; end++; break;
+        case 'G': case 'g': size <<= 30; end++; break;
+    }
+
+    return *end == 0 ? size : 0;
+}
+
+static void PrintUsage(const char* program) {
+    printf("Usage: %s [options] <output file, or - for stdout>\n"
+           "\n"
+           "Writes a W3C extended log like IIS does, the same bytes for the same options.\n"
+           "\n"
+           "Options:\n"
+           "  --seed <n>              picks the clients, paths and every request (default 1)\n"
+           "  --size <bytes>          stop after this much, 1M to 20G, K, M and G suffixes (default 64M)\n"
+           "  --restart-every <bytes> write the directives again with another #Fields list this often, like\n"
+           "                          IIS does when it restarts, 0 for never (default a quarter of --size)\n",
+           program);
+}
+
+int main(int argc, char** argv) {
+    uint64_t seed = 1;
+    uint64_t size = GENERATE_DEFAULT_SIZE;
+    uint64_t restartEvery = UINT64_MAX;
+    const char* path = 0;
+
+    for (int i = 1; i < argc; i++) {
+        int hasValue = i + 1 < argc;
+
+        if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            seed = strtoull(argv[++i], 0, 10);
+        } else if (strcmp(argv[i], "--size") == 0 && hasValue) {
+            size = ParseSize(argv[++i]);
+
+            if (size < GENERATE_MIN_SIZE || size > GENERATE_MAX_SIZE) {
+                fprintf(stderr, "The size has to be between 1M and 20G: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--restart-every") == 0 && hasValue) {
+            restartEvery = strcmp(argv[++i], "0") == 0 ? 0 : ParseSize(argv[i]);
+
+            if (restartEvery == 0 && strcmp(argv[i], "0") != 0) {
+                fprintf(stderr, "Invalid restart interval: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            PrintUsage(argv[0]);
+            return 1;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    if (path == 0) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    if (restartEvery == UINT64_MAX) {
+        restartEvery = size / 4;
+    }
+
+    Generator generator;
+    Output output = { .data = malloc(GENERATE_BUFFER_SIZE) };
+    output.file = strcmp(path, "-") == 0 ? stdout : fopen(path, "wb");
+
+    if (output.file == 0) {
+        printf("Unable to open file with the provided path: %s\n", path);
+        return 1;
+    }
+
+    if (output.data == 0 || Generator_Init(&generator, seed) != 0) {
+        puts("Unable to allocate memory for the generator.");
+        return 1;
+    }
+
+    int fieldListCount = sizeof(FIELD_LISTS) / sizeof(FIELD_LISTS[0]);
+    const FieldList* fieldList = &FIELD_LISTS[0];
+    uint64_t nextRestart = restartEvery > 0 ? restartEvery : UINT64_MAX;
+    WriteDirectives(&generator, &output, fieldList);
+
+    while (output.written + output.used < size && !output.failed) {
+        if (output.written + output.used >= nextRestart) {
+            fieldList = &FIELD_LISTS[Random_Below(&generator.random, fieldListCount)];
+            WriteDirectives(&generator, &output, fieldList);
+            nextRestart += restartEvery;
+        }
+
+        WriteRow(&generator, &output, fieldList);
+
+        if (output.used > GENERATE_BUFFER_SIZE - GENERATE_LINE_LIMIT) {
+            Output_Flush(&output);
+        }
+    }
+
+    Output_Flush(&output);
+
+    if ((fflush(output.file) != 0 || output.failed) || (output.file != stdout && fclose(output.file) != 0)) {
+        fprintf(stderr, "Unable to write to '%s'\n", path);
+        return 1;
+    }
+
+    if (output.file != stdout) {
+        printf("Wrote %llu bytes to '%s'\n", (unsigned long long)output.written, path);
+    }
+
+    free(output.data);
+    Generator_Free(&generator);
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#define CLAY_IMPLEMENTATION
+#include "include/clay.h"
+#include "renderers/raylib/clay_renderer_raylib.c"
+#include "engine/log_table.h"
+#include "benchmarks/bench_report.h"
+
+#define BENCHMARK_GLYPH_COUNT 400
+#define BENCHMARK_MAX_ROWS 100000
+#define BENCHMARK_MIN_SECONDS 0.2
+
+// Same glyph range as LoadFontEx(path, 48, 0, 400) in the viewer, made up so no window or GPU is needed.
+Font CreateBenchmarkFont(void) {
+    Font font = { .baseSize = 48, .glyphCount = BENCHMARK_GLYPH_COUNT };
+    font.glyphs = calloc(BENCHMARK_GLYPH_COUNT, sizeof(GlyphInfo));
+    font.recs = calloc(BENCHMARK_GLYPH_COUNT, sizeof(Rectangle));
+
+    for (int i = 0; i < BENCHMARK_GLYPH_COUNT; i++) {
+        font.glyphs[i].value = 32 + i;
+        font.glyphs[i].advanceX = 16 + (32 + i) % 13;
+    }
+
+    return font;
+}
+
+const char* SYNTHETIC_CELLS[] = {
+    "2024-05-01", "00:00:01", "10.0.0.1", "GET", "/api/orders/123", "-", "443", "192.168.1.10",
+    "Mozilla/5.0+(Windows+NT+10.0;+Win64;+x64)+AppleWebKit/537.36+(KHTML,+like+Gecko)+Chrome/124.0",
+    "https://example.com/caf\xc3\xa9/men\xc3\xba", "200", "0", "0", "15", "/api/orders/{id}", "browser"
+};
+
+int main(int argc, char** argv) {
+    int runCount = Bench_ParseRuns(&argc, argv);
+    LogTable table = { 0 };
+    Clay_StringSlice* cells;
+    uint64_t cellCount = 0;
+    uint64_t byteCount = 0;
+
+    if (argc > 1) {
+        if (LogTable_Load(&table, argv[1]) != 0) {
+            printf("Unable to open file with the provided path: %s\n", argv[1]);
+            return 1;
+        }
+
+        uint32_t rowCount = table.rowCount < BENCHMARK_MAX_ROWS ? table.rowCount : BENCHMARK_MAX_ROWS;
+        cells = malloc(((size_t)rowCount * table.columnCount + 1) * sizeof(Clay_StringSlice));
+
+        for (uint32_t row = 0; row < rowCount; row++) {
+            for (int column = 0; column < table.columnCount; column++) {
+                cells[cellCount++] = (Clay_StringSlice) { .length = (int32_t)LogTable_GetLength(&table, column, row), .chars = LogTable_GetValue(&table, column, row) };
+            }
+        }
+    } else {
+        cellCount = sizeof(SYNTHETIC_CELLS) / sizeof(SYNTHETIC_CELLS[0]);
+        cells = malloc(cellCount * sizeof(Clay_StringSlice));
+
+        for (uint64_t i = 0; i < cellCount; i++) {
+            cells[i] = (Clay_StringSlice) { .length = (int32_t)strlen(SYNTHETIC_CELLS[i]), .chars = SYNTHETIC_CELLS[i] };
+        }
+    }
+
+    for (uint64_t i = 0; i < cellCount; i++) {
+        byteCount += cells[i].length;
+    }
+
+    Font fonts[1] = { CreateBenchmarkFont() };
+    Clay_TextElementConfig config = { .fontId = 0, .fontSize = 16 };
+    volatile float totalWidth = 0;
+    BenchResult measurements = { .name = "measure text", .unit = "measurements/s", .higherIsBetter = 1, .runCount = runCount };
+    BenchResult throughput = { .name = "measure text bytes", .unit = "MB/s", .higherIsBetter = 1, .runCount = runCount };
+
+    for (int run = 0; run < runCount; run++) {
+        uint64_t passes = 0;
+        double start = Bench_Seconds();
+        double seconds = 0;
+
+        // Whole passes over the cells until enough time went by to be measurable.
+        while (seconds < BENCHMARK_MIN_SECONDS) {
+            for (uint64_t i = 0; i < cellCount; i++) {
+                totalWidth += Raylib_MeasureText(cells[i], &config, fonts).width;
+            }
+
+            passes++;
+            seconds = Bench_Seconds() - start;
+        }
+
+        measurements.runs[run] = cellCount * passes / seconds;
+        throughput.runs[run] = (double)byteCount * passes / seconds / (1024.0 * 1024.0);
+    }
+
+    Bench_Print(&measurements);
+    Bench_Print(&throughput);
+
+    free(cells);
+    free(fonts[0].glyphs);
+    free(fonts[0].recs);
+    LogTable_Free(&table);
+
+    return 0;
+}
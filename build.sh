@@ -1 +1 @@
-cd build && make && ./iis_log_viewer
+cd build && make && ./iis_log_viewer "$@"
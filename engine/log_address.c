@@ -0,0 +1,486 @@
+#include "log_address.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const uint8_t IPV4_MAPPED_PREFIX[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 0, 0, 0, 0 };
+
+static int GetBit(const uint8_t* key, int bit) {
+    return (key[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+// Number of leading bits a and b have in common, capped at limit.
+static int CommonPrefixLength(const uint8_t* a, const uint8_t* b, int limit) {
+    for (int byte = 0; byte * 8 < limit; byte++) {
+        uint8_t difference = a[byte] ^ b[byte];
+
+        if (difference != 0) {
+            int bit = byte * 8;
+
+            while ((difference & 0x80) == 0) {
+                difference <<= 1;
+                bit++;
+            }
+
+            return bit < limit ? bit : limit;
+        }
+    }
+
+    return limit;
+}
+
+static void MaskAddress(uint8_t* bytes, int prefixLength) {
+    for (int bit = prefixLength; bit < LOG_ADDRESS_BITS; bit++) {
+        bytes[bit >> 3] &= (uint8_t)~(0x80 >> (bit & 7));
+    }
+}
+
+static int ParseIpv4(const char* text, uint32_t length, uint8_t* bytes) {
+    int part = 0;
+    int value = -1;
+
+    for (uint32_t i = 0; i <= length; i++) {
+        if (i == length || text[i] == '.') {
+            if (value < 0 || part == 4) {
+                return 1;
+            }
+
+            bytes[part++] = (uint8_t)value;
+            value = -1;
+        } else if (text[i] >= '0' && text[i] <= '9') {
+            value = (value < 0 ? 0 : value * 10) + (text[i] - '0');
+
+            if (value > 255) {
+                return 1;
+            }
+        } else {
+            return 1;
+        }
+    }
+
+    return part == 4 ? 0 : 1;
+}
+
+static int ParseHexGroup(const char* text, uint32_t length, uint16_t* group) {
+    if (length == 0 || length > 4) {
+        return 1;
+    }
+
+    uint16_t value = 0;
+
+    for (uint32_t i = 0; i < length; i++) {
+        char c = text[i];
+        int digit;
+
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            digit = c - 'A' + 10;
+        } else {
+            return 1;
+        }
+
+        value = (uint16_t)(value * 16 + digit);
+    }
+
+    *group = value;
+    return 0;
+}
+
+static int ParseIpv6(const char* text, uint32_t length, uint8_t* bytes) {
+    uint16_t groups[8] = { 0 };
+    int groupCount = 0;
+    int compressAt = -1;
+    uint32_t i = 0;
+
+    // Drop the zone index, e.g. fe80::1%5
+    for (uint32_t j = 0; j < length; j++) {
+        if (text[j] == '%') {
+            length = j;
+            break;
+        }
+    }
+
+    if (length >= 2 && text[0] == ':' && text[1] == ':') {
+        compressAt = 0;
+        i = 2;
+    } else if (length == 0 || text[0] == ':') {
+        return 1;
+    }
+
+    while (i < length) {
+        uint32_t end = i;
+
+        while (end < length && text[end] != ':') {
+            end++;
+        }
+
+        if (memchr(text + i, '.', end - i) != 0) {
+            // Trailing dotted IPv4, e.g. ::ffff:10.0.0.1
+            uint8_t ipv4[4];
+
+            if (end != length || groupCount > 6 || ParseIpv4(text + i, end - i, ipv4) != 0) {
+                return 1;
+            }
+
+            groups[groupCount++] = (uint16_t)(ipv4[0] << 8 | ipv4[1]);
+            groups[groupCount++] = (uint16_t)(ipv4[2] << 8 | ipv4[3]);
+            break;
+        }
+
+        if (groupCount == 8 || ParseHexGroup(text + i, end - i, &groups[groupCount]) != 0) {
+            return 1;
+        }
+
+        groupCount++;
+
+        if (end == length) {
+            break;
+        }
+
+        if (end + 1 < length && text[end + 1] == ':') {
+            if (compressAt >= 0) {
+                return 1;
+            }
+
+            compressAt = groupCount;
+            i = end + 2;
+        } else {
+            i = end + 1;
+
+            if (i == length) {
+                return 1;
+            }
+        }
+    }
+
+    if ((compressAt < 0 && groupCount != 8) || (compressAt >= 0 && groupCount > 7)) {
+        return 1;
+    }
+
+    uint16_t expanded[8] = { 0 };
+
+    if (compressAt < 0) {
+        memcpy(expanded, groups, sizeof(groups));
+    } else {
+        int tail = groupCount - compressAt;
+        memcpy(expanded, groups, compressAt * sizeof(uint16_t));
+        memcpy(expanded + 8 - tail, groups + compressAt, tail * sizeof(uint16_t));
+    }
+
+    for (int group = 0; group < 8; group++) {
+        bytes[group * 2] = (uint8_t)(expanded[group] >> 8);
+        bytes[group * 2 + 1] = (uint8_t)(expanded[group] & 0xff);
+    }
+
+    return 0;
+}
+
+int LogAddress_Parse(const char* text, uint32_t length, LogAddress* address) {
+    memset(address, 0, sizeof(*address));
+
+    if (memchr(text, ':', length) == 0) {
+        memcpy(address->bytes, IPV4_MAPPED_PREFIX, sizeof(IPV4_MAPPED_PREFIX));
+
+        if (ParseIpv4(text, length, address->bytes + 12) != 0) {
+            return 1;
+        }
+
+        address->family = LOG_ADDRESS_FAMILY_IPV4;
+        return 0;
+    }
+
+    if (ParseIpv6(text, length, address->bytes) != 0) {
+        memset(address, 0, sizeof(*address));
+        return 1;
+    }
+
+    int isMapped = CommonPrefixLength(address->bytes, IPV4_MAPPED_PREFIX, LOG_ADDRESS_IPV4_OFFSET) == LOG_ADDRESS_IPV4_OFFSET;
+    address->family = isMapped ? LOG_ADDRESS_FAMILY_IPV4 : LOG_ADDRESS_FAMILY_IPV6;
+
+    return 0;
+}
+
+int LogAddress_ParseCidr(const char* text, uint32_t length, LogAddress* address, int* prefixLength) {
+    const char* slash = memchr(text, '/', length);
+    uint32_t addressLength = slash ? (uint32_t)(slash - text) : length;
+
+    if (LogAddress_Parse(text, addressLength, address) != 0) {
+        return 1;
+    }
+
+    int isDottedIpv4 = memchr(text, ':', addressLength) == 0;
+    int maximum = isDottedIpv4 ? LOG_ADDRESS_BITS - LOG_ADDRESS_IPV4_OFFSET : LOG_ADDRESS_BITS;
+    int bits = maximum;
+
+    if (slash != 0) {
+        bits = 0;
+        uint32_t digits = length - addressLength - 1;
+
+        if (digits == 0 || digits > 3) {
+            return 1;
+        }
+
+        for (const char* c = slash + 1; c < text + length; c++) {
+            if (*c < '0' || *c > '9') {
+                return 1;
+            }
+
+            bits = bits * 10 + (*c - '0');
+        }
+
+        if (bits > maximum) {
+            return 1;
+        }
+    }
+
+    *prefixLength = isDottedIpv4 ? bits + LOG_ADDRESS_IPV4_OFFSET : bits;
+    MaskAddress(address->bytes, *prefixLength);
+
+    return 0;
+}
+
+void LogAddress_FormatPrefix(const LogAddress* address, int prefixLength, char* buffer, int bufferSize) {
+    uint8_t bytes[16];
+    memcpy(bytes, address->bytes, sizeof(bytes));
+    MaskAddress(bytes, prefixLength);
+
+    int isIpv4 = prefixLength >= LOG_ADDRESS_IPV4_OFFSET && CommonPrefixLength(bytes, IPV4_MAPPED_PREFIX, LOG_ADDRESS_IPV4_OFFSET) == LOG_ADDRESS_IPV4_OFFSET;
+
+    if (isIpv4) {
+        snprintf(buffer, bufferSize, "%u.%u.%u.%u/%d", bytes[12], bytes[13], bytes[14], bytes[15], prefixLength - LOG_ADDRESS_IPV4_OFFSET);
+        return;
+    }
+
+    uint16_t groups[8];
+    int longestZeroRun = 0;
+    int longestZeroStart = -1;
+    int zeroRun = 0;
+
+    for (int group = 0; group < 8; group++) {
+        groups[group] = (uint16_t)(bytes[group * 2] << 8 | bytes[group * 2 + 1]);
+        zeroRun = groups[group] == 0 ? zeroRun + 1 : 0;
+
+        if (zeroRun > longestZeroRun) {
+            longestZeroRun = zeroRun;
+            longestZeroStart = group - zeroRun + 1;
+        }
+    }
+
+    if (longestZeroRun < 2) {
+        longestZeroStart = -1;
+    }
+
+    int written = 0;
+
+    for (int group = 0; group < 8 && written < bufferSize; group++) {
+        if (group == longestZeroStart) {
+            written += snprintf(buffer + written, bufferSize - written, "::");
+            group += longestZeroRun - 1;
+            continue;
+        }
+
+        int needsSeparator = group > 0 && group != longestZeroStart + longestZeroRun;
+        written += snprintf(buffer + written, bufferSize - written, needsSeparator ? ":%x" : "%x", groups[group]);
+    }
+
+    if (written < bufferSize) {
+        snprintf(buffer + written, bufferSize - written, "/%d", prefixLength);
+    }
+}
+
+int LogAddressTrie_Init(LogAddressTrie* trie, uint32_t valueCapacity) {
+    memset(trie, 0, sizeof(*trie));
+    trie->root = -1;
+    trie->valueCapacity = valueCapacity;
+    // A Patricia trie over n distinct keys never has more than 2n - 1 nodes.
+    trie->nodeCapacity = valueCapacity * 2 + 1;
+    trie->nodes = malloc(trie->nodeCapacity * sizeof(LogAddressNode));
+    trie->nextValueIds = malloc((valueCapacity > 0 ? valueCapacity : 1) * sizeof(int32_t));
+
+    if (trie->nodes == 0 || trie->nextValueIds == 0) {
+        LogAddressTrie_Free(trie);
+        return 1;
+    }
+
+    return 0;
+}
+
+void LogAddressTrie_Free(LogAddressTrie* trie) {
+    free(trie->nodes);
+    free(trie->nextValueIds);
+    memset(trie, 0, sizeof(*trie));
+    trie->root = -1;
+}
+
+static int32_t LogAddressTrie_AddNode(LogAddressTrie* trie, const uint8_t* key, int prefixLength, uint64_t count) {
+    int32_t index = (int32_t)trie->nodeCount++;
+    LogAddressNode* node = &trie->nodes[index];
+
+    memcpy(node->key, key, sizeof(node->key));
+    MaskAddress(node->key, prefixLength);
+    node->prefixLength = (uint8_t)prefixLength;
+    node->children[0] = -1;
+    node->children[1] = -1;
+    node->count = count;
+    node->valueId = -1;
+
+    return index;
+}
+
+void LogAddressTrie_Insert(LogAddressTrie* trie, const LogAddress* address, uint32_t valueId, uint64_t count) {
+    if (valueId >= trie->valueCapacity || trie->nodeCount + 2 > trie->nodeCapacity) {
+        return;
+    }
+
+    trie->nextValueIds[valueId] = -1;
+
+    int32_t parent = -1;
+    int parentSide = 0;
+    int32_t current = trie->root;
+
+    while (current >= 0) {
+        LogAddressNode* node = &trie->nodes[current];
+        int nodePrefixLength = node->prefixLength;
+        int common = CommonPrefixLength(address->bytes, node->key, nodePrefixLength);
+
+        if (common < nodePrefixLength) {
+            // The new address branches off in the middle of this node's prefix.
+            int32_t split = LogAddressTrie_AddNode(trie, address->bytes, common, node->count + count);
+            int32_t leaf = LogAddressTrie_AddNode(trie, address->bytes, LOG_ADDRESS_BITS, count);
+            int side = GetBit(address->bytes, common);
+
+            trie->nodes[leaf].valueId = (int32_t)valueId;
+            trie->nodes[split].children[side] = leaf;
+            trie->nodes[split].children[!side] = current;
+
+            if (parent < 0) {
+                trie->root = split;
+            } else {
+                trie->nodes[parent].children[parentSide] = split;
+            }
+
+            return;
+        }
+
+        node->count += count;
+
+        if (nodePrefixLength == LOG_ADDRESS_BITS) {
+            // Different spellings of the same address, e.g. "::1" and "0::1".
+            int32_t last = node->valueId;
+
+            while (trie->nextValueIds[last] >= 0) {
+                last = trie->nextValueIds[last];
+            }
+
+            trie->nextValueIds[last] = (int32_t)valueId;
+            return;
+        }
+
+        parent = current;
+        parentSide = GetBit(address->bytes, nodePrefixLength);
+        current = node->children[parentSide];
+    }
+
+    int32_t leaf = LogAddressTrie_AddNode(trie, address->bytes, LOG_ADDRESS_BITS, count);
+    trie->nodes[leaf].valueId = (int32_t)valueId;
+
+    if (parent < 0) {
+        trie->root = leaf;
+    } else {
+        trie->nodes[parent].children[parentSide] = leaf;
+    }
+}
+
+static void MarkSubtree(const LogAddressTrie* trie, int32_t index, uint8_t* marks) {
+    if (index < 0) {
+        return;
+    }
+
+    const LogAddressNode* node = &trie->nodes[index];
+
+    for (int32_t valueId = node->valueId; valueId >= 0; valueId = trie->nextValueIds[valueId]) {
+        marks[valueId] = 1;
+    }
+
+    MarkSubtree(trie, node->children[0], marks);
+    MarkSubtree(trie, node->children[1], marks);
+}
+
+void LogAddressTrie_MarkPrefix(const LogAddressTrie* trie, const LogAddress* prefix, int prefixLength, uint8_t* marks) {
+    int32_t current = trie->root;
+
+    while (current >= 0) {
+        const LogAddressNode* node = &trie->nodes[current];
+        int nodePrefixLength = node->prefixLength;
+        int limit = nodePrefixLength < prefixLength ? nodePrefixLength : prefixLength;
+
+        if (CommonPrefixLength(prefix->bytes, node->key, limit) < limit) {
+            return;
+        }
+
+        if (nodePrefixLength >= prefixLength) {
+            MarkSubtree(trie, current, marks);
+            return;
+        }
+
+        current = node->children[GetBit(prefix->bytes, nodePrefixLength)];
+    }
+}
+
+typedef struct {
+    LogAddressPrefix* prefixes;
+    uint32_t count;
+    uint32_t capacity;
+} PrefixList;
+
+static void CollectPrefixes(const LogAddressTrie* trie, int32_t index, int ipv4PrefixLength, int ipv6PrefixLength, PrefixList* list) {
+    if (index < 0) {
+        return;
+    }
+
+    const LogAddressNode* node = &trie->nodes[index];
+    int nodePrefixLength = node->prefixLength;
+    int mappedBits = nodePrefixLength < LOG_ADDRESS_IPV4_OFFSET ? nodePrefixLength : LOG_ADDRESS_IPV4_OFFSET;
+    int mayContainIpv4 = CommonPrefixLength(node->key, IPV4_MAPPED_PREFIX, mappedBits) == mappedBits;
+    int isIpv4 = mayContainIpv4 && nodePrefixLength >= LOG_ADDRESS_IPV4_OFFSET;
+    int target = isIpv4 ? LOG_ADDRESS_IPV4_OFFSET + ipv4PrefixLength : ipv6PrefixLength;
+
+    // Above the IPv4-mapped range a node can hold both families, so keep going down.
+    if ((!mayContainIpv4 || isIpv4) && nodePrefixLength >= target) {
+        if (list->count == list->capacity) {
+            list->capacity = list->capacity ? list->capacity * 2 : 64;
+            list->prefixes = realloc(list->prefixes, list->capacity * sizeof(LogAddressPrefix));
+        }
+
+        LogAddressPrefix* prefix = &list->prefixes[list->count++];
+        memcpy(prefix->prefix.bytes, node->key, sizeof(node->key));
+        MaskAddress(prefix->prefix.bytes, target);
+        prefix->prefix.family = isIpv4 ? LOG_ADDRESS_FAMILY_IPV4 : LOG_ADDRESS_FAMILY_IPV6;
+        prefix->prefixLength = target;
+        prefix->count = node->count;
+        return;
+    }
+
+    CollectPrefixes(trie, node->children[0], ipv4PrefixLength, ipv6PrefixLength, list);
+    CollectPrefixes(trie, node->children[1], ipv4PrefixLength, ipv6PrefixLength, list);
+}
+
+static int ComparePrefixCounts(const void* a, const void* b) {
+    uint64_t left = ((const LogAddressPrefix*)a)->count;
+    uint64_t right = ((const LogAddressPrefix*)b)->count;
+
+    return (left < right) - (left > right);
+}
+
+LogAddressPrefix* LogAddressTrie_GroupByPrefix(const LogAddressTrie* trie, int ipv4PrefixLength, int ipv6PrefixLength, uint32_t* outCount) {
+    PrefixList list = { 0 };
+
+    CollectPrefixes(trie, trie->root, ipv4PrefixLength, ipv6PrefixLength, &list);
+    qsort(list.prefixes, list.count, sizeof(LogAddressPrefix), ComparePrefixCounts);
+
+    *outCount = list.count;
+    return list.prefixes;
+}
@@ -0,0 +1,66 @@
+#ifndef IIS_LOG_ADDRESS_H
+#define IIS_LOG_ADDRESS_H
+
+#include <stdint.h>
+
+#define LOG_ADDRESS_BITS 128
+// IPv4 addresses are stored IPv4-mapped (::ffff:a.b.c.d), so their prefixes start at this bit.
+#define LOG_ADDRESS_IPV4_OFFSET 96
+#define LOG_ADDRESS_TEXT_LIMIT 64
+
+typedef enum {
+    LOG_ADDRESS_FAMILY_NONE,
+    LOG_ADDRESS_FAMILY_IPV4,
+    LOG_ADDRESS_FAMILY_IPV6
+} LogAddressFamily;
+
+typedef struct {
+    uint8_t bytes[16];
+    LogAddressFamily family;
+} LogAddress;
+
+// Returns 0 when the text is a valid IPv4 or IPv6 address.
+int LogAddress_Parse(const char* text, uint32_t length, LogAddress* address);
+// Parses "10.0.0.0/8" or "2001:db8::/32". The prefix length returned is in the 128-bit space.
+int LogAddress_ParseCidr(const char* text, uint32_t length, LogAddress* address, int* prefixLength);
+// Writes the address masked to prefixLength (128-bit space) in CIDR notation.
+void LogAddress_FormatPrefix(const LogAddress* address, int prefixLength, char* buffer, int bufferSize);
+
+typedef struct {
+    uint8_t key[16];
+    uint8_t prefixLength;
+    int32_t children[2];
+    uint64_t count;
+    // Only set on leaves, further values with the same address are chained through nextValueIds.
+    int32_t valueId;
+} LogAddressNode;
+
+// A compressed binary radix (Patricia) trie over 128-bit addresses. Each node keeps the number of
+// rows under it, so prefix totals and prefix lookups only cost a walk of at most 128 levels.
+typedef struct {
+    LogAddressNode* nodes;
+    uint32_t nodeCount;
+    uint32_t nodeCapacity;
+    int32_t root;
+    int32_t* nextValueIds;
+    uint32_t valueCapacity;
+} LogAddressTrie;
+
+typedef struct {
+    LogAddress prefix;
+    int prefixLength;
+    uint64_t count;
+} LogAddressPrefix;
+
+// Value ids are caller defined (usually dictionary ids) and must be below valueCapacity.
+int LogAddressTrie_Init(LogAddressTrie* trie, uint32_t valueCapacity);
+void LogAddressTrie_Insert(LogAddressTrie* trie, const LogAddress* address, uint32_t valueId, uint64_t count);
+void LogAddressTrie_Free(LogAddressTrie* trie);
+
+// Sets marks[valueId] = 1 for every value inside the prefix (128-bit space).
+void LogAddressTrie_MarkPrefix(const LogAddressTrie* trie, const LogAddress* prefix, int prefixLength, uint8_t* marks);
+
+// Totals per IPv4 /ipv4PrefixLength and IPv6 /ipv6PrefixLength, busiest first. The result is malloc'd.
+LogAddressPrefix* LogAddressTrie_GroupByPrefix(const LogAddressTrie* trie, int ipv4PrefixLength, int ipv6PrefixLength, uint32_t* outCount);
+
+#endif
@@ -0,0 +1,107 @@
+#include "log_agent.h"
+#include "log_aho_corasick.h"
+#include <string.h>
+
+typedef enum {
+    AGENT_CLASS_OTHER,
+    AGENT_CLASS_BROWSER,
+    AGENT_CLASS_BOT,
+    AGENT_CLASS_HEALTH_CHECK
+} AgentClass;
+
+typedef struct {
+    const char* token;
+    AgentClass agentClass;
+} AgentRule;
+
+// When several tokens match, the class that comes last in AgentClass wins, so a crawler that
+// claims to be Mozilla is still a bot.
+static const AgentRule AGENT_RULES[] = {
+    { "mozilla/", AGENT_CLASS_BROWSER },
+    { "opera/", AGENT_CLASS_BROWSER },
+    { "bot", AGENT_CLASS_BOT },
+    { "crawl", AGENT_CLASS_BOT },
+    { "spider", AGENT_CLASS_BOT },
+    { "slurp", AGENT_CLASS_BOT },
+    { "bingpreview", AGENT_CLASS_BOT },
+    { "facebookexternalhit", AGENT_CLASS_BOT },
+    { "mediapartners-google", AGENT_CLASS_BOT },
+    { "ahrefs", AGENT_CLASS_BOT },
+    { "semrush", AGENT_CLASS_BOT },
+    { "yandex", AGENT_CLASS_BOT },
+    { "baiduspider", AGENT_CLASS_BOT },
+    { "headlesschrome", AGENT_CLASS_BOT },
+    { "phantomjs", AGENT_CLASS_BOT },
+    { "python-requests", AGENT_CLASS_BOT },
+    { "python-urllib", AGENT_CLASS_BOT },
+    { "curl/", AGENT_CLASS_BOT },
+    { "wget/", AGENT_CLASS_BOT },
+    { "go-http-client", AGENT_CLASS_BOT },
+    { "java/", AGENT_CLASS_BOT },
+    { "okhttp", AGENT_CLASS_BOT },
+    { "libwww", AGENT_CLASS_BOT },
+    { "scrapy", AGENT_CLASS_BOT },
+    { "httpclient", AGENT_CLASS_BOT },
+    { "kube-probe", AGENT_CLASS_HEALTH_CHECK },
+    { "elb-healthchecker", AGENT_CLASS_HEALTH_CHECK },
+    { "healthcheck", AGENT_CLASS_HEALTH_CHECK },
+    { "health-check", AGENT_CLASS_HEALTH_CHECK },
+    { "googlehc", AGENT_CLASS_HEALTH_CHECK },
+    { "alwayson", AGENT_CLASS_HEALTH_CHECK },
+    { "pingdom", AGENT_CLASS_HEALTH_CHECK },
+    { "uptimerobot", AGENT_CLASS_HEALTH_CHECK },
+    { "statuscake", AGENT_CLASS_HEALTH_CHECK },
+    { "site24x7", AGENT_CLASS_HEALTH_CHECK },
+    { "nagios", AGENT_CLASS_HEALTH_CHECK },
+    { "zabbix", AGENT_CLASS_HEALTH_CHECK },
+};
+
+#define AGENT_RULE_COUNT (int)(sizeof(AGENT_RULES) / sizeof(AGENT_RULES[0]))
+
+static const char* AGENT_CLASS_NAMES[] = { LOG_AGENT_OTHER, LOG_AGENT_BROWSER, LOG_AGENT_BOT, LOG_AGENT_HEALTH_CHECK };
+
+static void KeepStrongestClass(int pattern, uint64_t end, void* userData) {
+    (void)end;
+    AgentClass* agentClass = userData;
+
+    if (AGENT_RULES[pattern].agentClass > *agentClass) {
+        *agentClass = AGENT_RULES[pattern].agentClass;
+    }
+}
+
+static uint32_t ClassifyAgent(const char* value, uint32_t length, char* out, uint32_t outCapacity, void* userData) {
+    if (length == 1 && value[0] == '-') {
+        out[0] = '-';
+        return 1;
+    }
+
+    AgentClass agentClass = AGENT_CLASS_OTHER;
+    LogAhoCorasick_Scan(userData, 0, value, length, KeepStrongestClass, &agentClass);
+
+    uint32_t classLength = (uint32_t)strlen(AGENT_CLASS_NAMES[agentClass]);
+    classLength = classLength < outCapacity ? classLength : outCapacity;
+    memcpy(out, AGENT_CLASS_NAMES[agentClass], classLength);
+
+    return classLength;
+}
+
+int LogAgent_AddColumn(LogTable* table) {
+    const char* tokens[AGENT_RULE_COUNT];
+    uint32_t tokenLengths[AGENT_RULE_COUNT];
+
+    for (int i = 0; i < AGENT_RULE_COUNT; i++) {
+        tokens[i] = AGENT_RULES[i].token;
+        tokenLengths[i] = (uint32_t)strlen(AGENT_RULES[i].token);
+    }
+
+    LogAhoCorasick automaton;
+
+    if (LogAhoCorasick_Build(&automaton, tokens, tokenLengths, AGENT_RULE_COUNT) != 0) {
+        return -1;
+    }
+
+    int column = LogTable_AddDerivedColumn(table, LOG_AGENT_COLUMN, table->userAgentColumn, ClassifyAgent, &automaton);
+    LogAhoCorasick_Free(&automaton);
+
+    return column;
+}
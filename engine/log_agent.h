@@ -0,0 +1,19 @@
+#ifndef IIS_LOG_AGENT_H
+#define IIS_LOG_AGENT_H
+
+#include "log_table.h"
+
+#define LOG_AGENT_COLUMN "agent"
+
+// Values of the agent column.
+#define LOG_AGENT_BOT "bot"
+#define LOG_AGENT_HEALTH_CHECK "health-check"
+#define LOG_AGENT_BROWSER "browser"
+#define LOG_AGENT_OTHER "other"
+
+// Adds the agent column to the table, classifying each distinct cs(UserAgent) once against the
+// known token list. Filtering on it (e.g. 'agent != bot') then only compares ids per row.
+// Returns the column index or -1.
+int LogAgent_AddColumn(LogTable* table);
+
+#endif
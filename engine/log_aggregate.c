@@ -0,0 +1,215 @@
+#include "log_aggregate.h"
+#include "log_thread.h"
+#include "log_trace.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int CompareUint32(const void* a, const void* b) {
+    uint32_t left = *(const uint32_t*)a;
+    uint32_t right = *(const uint32_t*)b;
+
+    return (left > right) - (left < right);
+}
+
+static uint32_t Percentile(const uint32_t* sortedValues, uint32_t count, uint32_t percent) {
+    if (count == 0) {
+        return 0;
+    }
+
+    uint32_t index = (uint32_t)(((uint64_t)count * percent + 99) / 100);
+
+    return sortedValues[index > 0 ? index - 1 : 0];
+}
+
+int LogAggregate_Build(LogAggregate* aggregate, const LogTable* table, int keyColumn, const uint32_t* rows, uint32_t rowCount) {
+    memset(aggregate, 0, sizeof(*aggregate));
+
+    if (keyColumn < 0 || keyColumn >= table->columnCount) {
+        return 1;
+    }
+
+    if (rows == 0) {
+        rowCount = table->rowCount;
+    }
+
+    aggregate->table = table;
+    aggregate->keyColumn = keyColumn;
+    aggregate->groupCount = table->columns[keyColumn].dictionary.count;
+    aggregate->groups = calloc(aggregate->groupCount, sizeof(LogGroup));
+    // Counting sort of time-taken by key, so each group's latencies end up contiguous.
+    uint32_t* offsets = calloc(aggregate->groupCount + 1, sizeof(uint32_t));
+    uint32_t* timeTaken = malloc((rowCount > 0 ? rowCount : 1) * sizeof(uint32_t));
+
+    if (aggregate->groups == 0 || offsets == 0 || timeTaken == 0) {
+        free(offsets);
+        free(timeTaken);
+        LogAggregate_Free(aggregate);
+        return 1;
+    }
+
+    const uint32_t* keyIds = table->columns[keyColumn].ids;
+
+    for (uint32_t i = 0; i < rowCount; i++) {
+        uint32_t row = rows ? rows[i] : i;
+        LogGroup* group = &aggregate->groups[keyIds[row]];
+        int64_t status = LogTable_GetNumber(table, table->statusColumn, row);
+        int64_t taken = LogTable_GetNumber(table, table->timeTakenColumn, row);
+
+        group->count++;
+
+        if (status >= LOG_ERROR_STATUS_MIN) {
+            group->errorCount++;
+        }
+
+        if (taken != LOG_INVALID_NUMBER) {
+            group->totalTimeTaken += (uint64_t)taken;
+            offsets[keyIds[row] + 1]++;
+        }
+    }
+
+    for (uint32_t id = 0; id < aggregate->groupCount; id++) {
+        aggregate->groups[id].keyId = id;
+        offsets[id + 1] += offsets[id];
+    }
+
+    uint32_t* cursors = malloc((aggregate->groupCount > 0 ? aggregate->groupCount : 1) * sizeof(uint32_t));
+    memcpy(cursors, offsets, aggregate->groupCount * sizeof(uint32_t));
+
+    for (uint32_t i = 0; i < rowCount; i++) {
+        uint32_t row = rows ? rows[i] : i;
+        int64_t taken = LogTable_GetNumber(table, table->timeTakenColumn, row);
+
+        if (taken != LOG_INVALID_NUMBER) {
+            timeTaken[cursors[keyIds[row]]++] = (uint32_t)taken;
+        }
+    }
+
+    for (uint32_t id = 0; id < aggregate->groupCount; id++) {
+        uint32_t* values = timeTaken + offsets[id];
+        uint32_t count = offsets[id + 1] - offsets[id];
+        LogGroup* group = &aggregate->groups[id];
+
+        qsort(values, count, sizeof(uint32_t), CompareUint32);
+        group->p50 = Percentile(values, count, 50);
+        group->p95 = Percentile(values, count, 95);
+        group->p99 = Percentile(values, count, 99);
+    }
+
+    free(cursors);
+    free(offsets);
+    free(timeTaken);
+
+    return 0;
+}
+
+void LogAggregate_Free(LogAggregate* aggregate) {
+    free(aggregate->groups);
+    memset(aggregate, 0, sizeof(*aggregate));
+}
+
+typedef struct {
+    LogAggregate* aggregate;
+    const LogTable* table;
+    int keyColumn;
+    int result;
+} AggregateJob;
+
+static void RunAggregateJob(void* userData) {
+    AggregateJob* job = userData;
+    LOG_TRACE("aggregate") job->result = LogAggregate_Build(job->aggregate, job->table, job->keyColumn, 0, 0);
+}
+
+static uint32_t ComparisonRowCount(const LogComparisonRow* row) {
+    return (row->before ? row->before->count : 0) + (row->after ? row->after->count : 0);
+}
+
+static int CompareComparisonRows(const void* a, const void* b) {
+    uint32_t left = ComparisonRowCount(a);
+    uint32_t right = ComparisonRowCount(b);
+
+    return (left < right) - (left > right);
+}
+
+int LogComparison_Build(LogComparison* comparison, const LogTable* before, const LogTable* after, const char* keyColumnName) {
+    memset(comparison, 0, sizeof(*comparison));
+
+    AggregateJob jobs[2] = {
+        { .aggregate = &comparison->before, .table = before, .keyColumn = LogTable_FindColumn(before, keyColumnName), .result = 1 },
+        { .aggregate = &comparison->after, .table = after, .keyColumn = LogTable_FindColumn(after, keyColumnName), .result = 1 },
+    };
+
+    // Aggregate the second log on a worker while this thread does the first one.
+    LogThread thread;
+    int threadStarted = LogThread_Start(&thread, RunAggregateJob, &jobs[1]) == 0;
+    RunAggregateJob(&jobs[0]);
+
+    if (threadStarted) {
+        LogThread_Join(thread);
+    } else {
+        RunAggregateJob(&jobs[1]);
+    }
+
+    if (jobs[0].result != 0 || jobs[1].result != 0) {
+        LogComparison_Free(comparison);
+        return 1;
+    }
+
+    const LogDictionary* beforeKeys = &before->columns[jobs[0].keyColumn].dictionary;
+    const LogDictionary* afterKeys = &after->columns[jobs[1].keyColumn].dictionary;
+    comparison->rows = malloc((beforeKeys->count + afterKeys->count) * sizeof(LogComparisonRow));
+
+    if (comparison->rows == 0) {
+        LogComparison_Free(comparison);
+        return 1;
+    }
+
+    for (uint32_t id = 0; id < comparison->before.groupCount; id++) {
+        const LogGroup* group = &comparison->before.groups[id];
+
+        if (group->count == 0) {
+            continue;
+        }
+
+        int64_t afterId = LogDictionary_Find(afterKeys, beforeKeys->values[id], beforeKeys->lengths[id]);
+        const LogGroup* afterGroup = afterId >= 0 ? &comparison->after.groups[afterId] : 0;
+
+        comparison->rows[comparison->rowCount++] = (LogComparisonRow) {
+            .key = beforeKeys->values[id],
+            .keyLength = beforeKeys->lengths[id],
+            .before = group,
+            .after = afterGroup && afterGroup->count > 0 ? afterGroup : 0
+        };
+    }
+
+    for (uint32_t id = 0; id < comparison->after.groupCount; id++) {
+        const LogGroup* group = &comparison->after.groups[id];
+
+        if (group->count == 0) {
+            continue;
+        }
+
+        int64_t beforeId = LogDictionary_Find(beforeKeys, afterKeys->values[id], afterKeys->lengths[id]);
+
+        if (beforeId >= 0 && comparison->before.groups[beforeId].count > 0) {
+            continue;
+        }
+
+        comparison->rows[comparison->rowCount++] = (LogComparisonRow) {
+            .key = afterKeys->values[id],
+            .keyLength = afterKeys->lengths[id],
+            .before = 0,
+            .after = group
+        };
+    }
+
+    qsort(comparison->rows, comparison->rowCount, sizeof(LogComparisonRow), CompareComparisonRows);
+
+    return 0;
+}
+
+void LogComparison_Free(LogComparison* comparison) {
+    LogAggregate_Free(&comparison->before);
+    LogAggregate_Free(&comparison->after);
+    free(comparison->rows);
+    memset(comparison, 0, sizeof(*comparison));
+}
@@ -0,0 +1,57 @@
+#ifndef IIS_LOG_AGGREGATE_H
+#define IIS_LOG_AGGREGATE_H
+
+#include "log_table.h"
+
+// Responses with a status at or above this are counted as errors.
+#define LOG_ERROR_STATUS_MIN 500
+
+typedef struct {
+    uint32_t keyId;
+    uint32_t count;
+    uint32_t errorCount;
+    uint64_t totalTimeTaken;
+    // time-taken percentiles, in milliseconds
+    uint32_t p50;
+    uint32_t p95;
+    uint32_t p99;
+} LogGroup;
+
+// Groups rows by the dictionary id of a column. Since ids are dense there's one group per
+// distinct value and no hashing is needed, groups that no row fell into have a count of 0.
+typedef struct {
+    const LogTable* table;
+    int keyColumn;
+    LogGroup* groups;
+    uint32_t groupCount;
+} LogAggregate;
+
+// Aggregates the given rows, or every row in the table when rows is 0. Returns 0 on success.
+int LogAggregate_Build(LogAggregate* aggregate, const LogTable* table, int keyColumn, const uint32_t* rows, uint32_t rowCount);
+void LogAggregate_Free(LogAggregate* aggregate);
+
+static inline float LogGroup_ErrorRate(const LogGroup* group) {
+    return group == 0 || group->count == 0 ? 0.0f : (float)group->errorCount / (float)group->count;
+}
+
+typedef struct {
+    const char* key;
+    uint32_t keyLength;
+    // Either side is 0 when the key only occurs in the other log.
+    const LogGroup* before;
+    const LogGroup* after;
+} LogComparisonRow;
+
+typedef struct {
+    LogAggregate before;
+    LogAggregate after;
+    LogComparisonRow* rows;
+    uint32_t rowCount;
+} LogComparison;
+
+// Aggregates both tables by the named column in parallel and joins the results by value,
+// busiest keys first. Returns 0 on success.
+int LogComparison_Build(LogComparison* comparison, const LogTable* before, const LogTable* after, const char* keyColumnName);
+void LogComparison_Free(LogComparison* comparison);
+
+#endif
@@ -0,0 +1,176 @@
+#include "log_aho_corasick.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_AHO_CORASICK_ROOT 0
+
+static int32_t LogAhoCorasick_AddState(LogAhoCorasick* automaton) {
+    if (automaton->stateCount == automaton->stateCapacity) {
+        int32_t capacity = automaton->stateCapacity * 2;
+        int32_t* transitions = realloc(automaton->transitions, (size_t)capacity * LOG_AHO_CORASICK_ALPHABET * sizeof(int32_t));
+        int32_t* patterns = realloc(automaton->patterns, capacity * sizeof(int32_t));
+        int32_t* outputLinks = realloc(automaton->outputLinks, capacity * sizeof(int32_t));
+
+        if (transitions != 0) {
+            automaton->transitions = transitions;
+        }
+
+        if (patterns != 0) {
+            automaton->patterns = patterns;
+        }
+
+        if (outputLinks != 0) {
+            automaton->outputLinks = outputLinks;
+        }
+
+        if (transitions == 0 || patterns == 0 || outputLinks == 0) {
+            return -1;
+        }
+
+        automaton->stateCapacity = capacity;
+    }
+
+    int32_t state = automaton->stateCount++;
+
+    for (int c = 0; c < LOG_AHO_CORASICK_ALPHABET; c++) {
+        automaton->transitions[(size_t)state * LOG_AHO_CORASICK_ALPHABET + c] = -1;
+    }
+
+    automaton->patterns[state] = -1;
+    automaton->outputLinks[state] = -1;
+
+    return state;
+}
+
+int LogAhoCorasick_Build(LogAhoCorasick* automaton, const char* const* patterns, const uint32_t* patternLengths, int patternCount) {
+    memset(automaton, 0, sizeof(*automaton));
+    automaton->stateCapacity = 64;
+    automaton->transitions = malloc((size_t)automaton->stateCapacity * LOG_AHO_CORASICK_ALPHABET * sizeof(int32_t));
+    automaton->patterns = malloc(automaton->stateCapacity * sizeof(int32_t));
+    automaton->outputLinks = malloc(automaton->stateCapacity * sizeof(int32_t));
+    automaton->patternLengths = calloc(patternCount > 0 ? patternCount : 1, sizeof(uint32_t));
+    automaton->patternCount = patternCount;
+
+    if (automaton->transitions == 0 || automaton->patterns == 0 || automaton->outputLinks == 0 || automaton->patternLengths == 0) {
+        LogAhoCorasick_Free(automaton);
+        return 1;
+    }
+
+    LogAhoCorasick_AddState(automaton);
+
+    // Build the trie over lowercased patterns.
+    for (int pattern = 0; pattern < patternCount; pattern++) {
+        int32_t state = LOG_AHO_CORASICK_ROOT;
+        automaton->patternLengths[pattern] = patternLengths[pattern];
+
+        if (patternLengths[pattern] == 0) {
+            continue;
+        }
+
+        for (uint32_t i = 0; i < patternLengths[pattern]; i++) {
+            int c = tolower((unsigned char)patterns[pattern][i]);
+            int32_t next = automaton->transitions[(size_t)state * LOG_AHO_CORASICK_ALPHABET + c];
+
+            if (next < 0) {
+                next = LogAhoCorasick_AddState(automaton);
+
+                if (next < 0) {
+                    LogAhoCorasick_Free(automaton);
+                    return 1;
+                }
+
+                automaton->transitions[(size_t)state * LOG_AHO_CORASICK_ALPHABET + c] = next;
+            }
+
+            state = next;
+        }
+
+        if (automaton->patterns[state] < 0) {
+            automaton->patterns[state] = pattern;
+        }
+    }
+
+    // Breadth-first pass turning failure links into direct transitions.
+    int32_t* queue = malloc(automaton->stateCount * sizeof(int32_t));
+    int32_t* failures = malloc(automaton->stateCount * sizeof(int32_t));
+
+    if (queue == 0 || failures == 0) {
+        free(queue);
+        free(failures);
+        LogAhoCorasick_Free(automaton);
+        return 1;
+    }
+
+    int32_t head = 0;
+    int32_t tail = 0;
+    failures[LOG_AHO_CORASICK_ROOT] = LOG_AHO_CORASICK_ROOT;
+
+    for (int c = 0; c < LOG_AHO_CORASICK_ALPHABET; c++) {
+        int32_t* transition = &automaton->transitions[LOG_AHO_CORASICK_ROOT * LOG_AHO_CORASICK_ALPHABET + c];
+
+        if (*transition < 0) {
+            *transition = LOG_AHO_CORASICK_ROOT;
+        } else {
+            failures[*transition] = LOG_AHO_CORASICK_ROOT;
+            queue[tail++] = *transition;
+        }
+    }
+
+    while (head < tail) {
+        int32_t state = queue[head++];
+        int32_t failure = failures[state];
+
+        automaton->outputLinks[state] = automaton->patterns[failure] >= 0 ? failure : automaton->outputLinks[failure];
+
+        for (int c = 0; c < LOG_AHO_CORASICK_ALPHABET; c++) {
+            int32_t* transition = &automaton->transitions[(size_t)state * LOG_AHO_CORASICK_ALPHABET + c];
+            int32_t fallback = automaton->transitions[(size_t)failure * LOG_AHO_CORASICK_ALPHABET + c];
+
+            if (*transition < 0) {
+                *transition = fallback;
+            } else {
+                failures[*transition] = fallback;
+                queue[tail++] = *transition;
+            }
+        }
+    }
+
+    // Fold case into the table so scanning doesn't need tolower.
+    for (int32_t state = 0; state < automaton->stateCount; state++) {
+        int32_t* row = &automaton->transitions[(size_t)state * LOG_AHO_CORASICK_ALPHABET];
+
+        for (int c = 'A'; c <= 'Z'; c++) {
+            row[c] = row[tolower(c)];
+        }
+    }
+
+    free(queue);
+    free(failures);
+
+    return 0;
+}
+
+void LogAhoCorasick_Free(LogAhoCorasick* automaton) {
+    free(automaton->transitions);
+    free(automaton->patterns);
+    free(automaton->outputLinks);
+    free(automaton->patternLengths);
+    memset(automaton, 0, sizeof(*automaton));
+}
+
+int32_t LogAhoCorasick_Scan(const LogAhoCorasick* automaton, int32_t state, const char* text, uint64_t length, LogAhoCorasickMatchFunction onMatch, void* userData) {
+    const int32_t* transitions = automaton->transitions;
+    const int32_t* patterns = automaton->patterns;
+    const int32_t* outputLinks = automaton->outputLinks;
+
+    for (uint64_t i = 0; i < length; i++) {
+        state = transitions[(size_t)state * LOG_AHO_CORASICK_ALPHABET + (unsigned char)text[i]];
+
+        for (int32_t output = patterns[state] >= 0 ? state : outputLinks[state]; output >= 0; output = outputLinks[output]) {
+            onMatch(patterns[output], i + 1, userData);
+        }
+    }
+
+    return state;
+}
@@ -0,0 +1,32 @@
+#ifndef IIS_LOG_AHO_CORASICK_H
+#define IIS_LOG_AHO_CORASICK_H
+
+#include <stdint.h>
+
+#define LOG_AHO_CORASICK_ALPHABET 256
+
+// Multi-pattern matcher. The trie is compiled into a full transition table, so scanning costs one
+// table lookup per input byte no matter how many patterns there are. Matching is case-insensitive.
+typedef struct {
+    int32_t* transitions;
+    // Pattern that ends at each state, or -1.
+    int32_t* patterns;
+    // Next state down the failure chain that also ends a pattern, or -1.
+    int32_t* outputLinks;
+    uint32_t* patternLengths;
+    int32_t stateCount;
+    int32_t stateCapacity;
+    int patternCount;
+} LogAhoCorasick;
+
+typedef void (*LogAhoCorasickMatchFunction)(int pattern, uint64_t end, void* userData);
+
+// Returns 0 on success. Patterns are copied into the automaton, empty ones are ignored.
+int LogAhoCorasick_Build(LogAhoCorasick* automaton, const char* const* patterns, const uint32_t* patternLengths, int patternCount);
+void LogAhoCorasick_Free(LogAhoCorasick* automaton);
+
+// Scans text from the given state and returns the state to continue from, so a stream can be fed in
+// pieces. onMatch gets every occurrence of every pattern with the offset one past its last byte.
+int32_t LogAhoCorasick_Scan(const LogAhoCorasick* automaton, int32_t state, const char* text, uint64_t length, LogAhoCorasickMatchFunction onMatch, void* userData);
+
+#endif
@@ -0,0 +1,245 @@
+#include "log_columnar.h"
+#include <stdlib.h>
+#include <string.h>
+
+// The buffer goes out to the file whenever it grows past this.
+#define COLUMNAR_FLUSH_SIZE (4 << 20)
+
+typedef struct {
+    uint8_t* data;
+    size_t used;
+    size_t capacity;
+    FILE* file;
+    int failed;
+} ColumnarBuffer;
+
+static void ColumnarBuffer_Reserve(ColumnarBuffer* buffer, size_t size) {
+    if (buffer->used + size <= buffer->capacity || buffer->failed) {
+        return;
+    }
+
+    size_t capacity = buffer->capacity > 0 ? buffer->capacity : COLUMNAR_FLUSH_SIZE;
+
+    while (capacity < buffer->used + size) {
+        capacity *= 2;
+    }
+
+    uint8_t* data = realloc(buffer->data, capacity);
+
+    if (data == 0) {
+        buffer->failed = 1;
+        return;
+    }
+
+    buffer->data = data;
+    buffer->capacity = capacity;
+}
+
+static void ColumnarBuffer_Flush(ColumnarBuffer* buffer) {
+    if (buffer->used > 0 && !buffer->failed && fwrite(buffer->data, 1, buffer->used, buffer->file) != buffer->used) {
+        buffer->failed = 1;
+    }
+
+    buffer->used = 0;
+}
+
+static void ColumnarBuffer_PutBytes(ColumnarBuffer* buffer, const void* bytes, size_t size) {
+    ColumnarBuffer_Reserve(buffer, size);
+
+    if (!buffer->failed) {
+        memcpy(buffer->data + buffer->used, bytes, size);
+        buffer->used += size;
+    }
+}
+
+static void ColumnarBuffer_PutByte(ColumnarBuffer* buffer, uint8_t value) {
+    ColumnarBuffer_PutBytes(buffer, &value, 1);
+}
+
+static void ColumnarBuffer_PutInteger(ColumnarBuffer* buffer, uint64_t value, int size) {
+    uint8_t bytes[8];
+
+    for (int i = 0; i < size; i++) {
+        bytes[i] = (uint8_t)(value >> (8 * i));
+    }
+
+    ColumnarBuffer_PutBytes(buffer, bytes, size);
+}
+
+static void ColumnarBuffer_PutVarint(ColumnarBuffer* buffer, uint64_t value) {
+    uint8_t bytes[10];
+    int size = 0;
+
+    do {
+        bytes[size] = (uint8_t)(value & 0x7f);
+        value >>= 7;
+        bytes[size++] |= value != 0 ? 0x80 : 0;
+    } while (value != 0);
+
+    ColumnarBuffer_PutBytes(buffer, bytes, size);
+}
+
+static uint32_t VarintSize(uint64_t value) {
+    uint32_t size = 1;
+
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+
+    return size;
+}
+
+static int BitWidth(uint32_t value) {
+    int width = 0;
+
+    while (value != 0) {
+        value >>= 1;
+        width++;
+    }
+
+    return width;
+}
+
+static void WriteChunk(ColumnarBuffer* buffer, const uint32_t* ids, uint32_t count, int width) {
+    uint64_t packedSize = ((uint64_t)count * width + 7) / 8;
+    uint64_t runsSize = 0;
+
+    for (uint32_t i = 0; i < count;) {
+        uint32_t end = i + 1;
+
+        while (end < count && ids[end] == ids[i]) {
+            end++;
+        }
+
+        runsSize += VarintSize(end - i) + VarintSize(ids[i]);
+        i = end;
+    }
+
+    if (runsSize < packedSize) {
+        ColumnarBuffer_PutByte(buffer, LOG_COLUMNAR_ENCODING_RUNS);
+        ColumnarBuffer_PutVarint(buffer, runsSize);
+
+        for (uint32_t i = 0; i < count;) {
+            uint32_t end = i + 1;
+
+            while (end < count && ids[end] == ids[i]) {
+                end++;
+            }
+
+            ColumnarBuffer_PutVarint(buffer, end - i);
+            ColumnarBuffer_PutVarint(buffer, ids[i]);
+            i = end;
+        }
+
+        return;
+    }
+
+    ColumnarBuffer_PutByte(buffer, LOG_COLUMNAR_ENCODING_PACKED);
+    ColumnarBuffer_PutVarint(buffer, packedSize);
+    ColumnarBuffer_Reserve(buffer, packedSize);
+
+    if (buffer->failed) {
+        return;
+    }
+
+    uint8_t* out = buffer->data + buffer->used;
+    uint64_t bits = 0;
+    int bitCount = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        bits |= (uint64_t)ids[i] << bitCount;
+        bitCount += width;
+
+        while (bitCount >= 8) {
+            *out++ = (uint8_t)bits;
+            bits >>= 8;
+            bitCount -= 8;
+        }
+    }
+
+    if (bitCount > 0) {
+        *out++ = (uint8_t)bits;
+    }
+
+    buffer->used += packedSize;
+}
+
+int LogColumnar_Write(const LogTable* table, const uint32_t* rows, uint32_t rowCount, FILE* file, volatile uint32_t* rowsWritten) {
+    if (rows == 0) {
+        rowCount = table->rowCount;
+    }
+
+    ColumnarBuffer buffer = { .file = file };
+    uint32_t* chunkIds = malloc(LOG_COLUMNAR_CHUNK_ROWS * sizeof(uint32_t));
+
+    if (chunkIds == 0) {
+        return 1;
+    }
+
+    ColumnarBuffer_PutBytes(&buffer, LOG_COLUMNAR_MAGIC, sizeof(LOG_COLUMNAR_MAGIC));
+    ColumnarBuffer_PutInteger(&buffer, LOG_COLUMNAR_VERSION, 4);
+    ColumnarBuffer_PutInteger(&buffer, (uint64_t)table->columnCount, 4);
+    ColumnarBuffer_PutInteger(&buffer, rowCount, 8);
+    ColumnarBuffer_PutInteger(&buffer, LOG_COLUMNAR_CHUNK_ROWS, 4);
+
+    for (int column = 0; column < table->columnCount && !buffer.failed; column++) {
+        const LogColumn* logColumn = &table->columns[column];
+        const LogDictionary* dictionary = &logColumn->dictionary;
+        size_t nameLength = strlen(logColumn->name);
+
+        ColumnarBuffer_PutByte(&buffer, (uint8_t)nameLength);
+        ColumnarBuffer_PutBytes(&buffer, logColumn->name, nameLength);
+        ColumnarBuffer_PutByte(&buffer, (uint8_t)logColumn->type);
+        ColumnarBuffer_PutByte(&buffer, (uint8_t)(logColumn->isDerived != 0));
+        ColumnarBuffer_PutVarint(&buffer, dictionary->count);
+
+        for (uint32_t id = 0; id < dictionary->count; id++) {
+            ColumnarBuffer_PutVarint(&buffer, dictionary->lengths[id]);
+            ColumnarBuffer_PutBytes(&buffer, dictionary->values[id], dictionary->lengths[id]);
+
+            if (buffer.used >= COLUMNAR_FLUSH_SIZE) {
+                ColumnarBuffer_Flush(&buffer);
+            }
+        }
+
+        if (logColumn->type != LOG_COLUMN_TYPE_TEXT) {
+            for (uint32_t id = 0; id < dictionary->count; id++) {
+                int64_t number = dictionary->numbers[id];
+                ColumnarBuffer_PutVarint(&buffer, ((uint64_t)number << 1) ^ (uint64_t)(number >> 63));
+            }
+        }
+
+        int width = BitWidth(dictionary->count > 0 ? dictionary->count - 1 : 0);
+
+        for (uint32_t start = 0; start < rowCount && !buffer.failed; start += LOG_COLUMNAR_CHUNK_ROWS) {
+            uint32_t count = rowCount - start < LOG_COLUMNAR_CHUNK_ROWS ? rowCount - start : LOG_COLUMNAR_CHUNK_ROWS;
+
+            for (uint32_t i = 0; i < count; i++) {
+                chunkIds[i] = logColumn->ids[rows ? rows[start + i] : start + i];
+            }
+
+            WriteChunk(&buffer, chunkIds, count, width);
+
+            if (buffer.used >= COLUMNAR_FLUSH_SIZE) {
+                ColumnarBuffer_Flush(&buffer);
+            }
+
+            if (rowsWritten != 0) {
+                // Columns are written one after the other, so progress is spread over all of them.
+                *rowsWritten = (uint32_t)(((uint64_t)column * rowCount + start + count) / (uint64_t)table->columnCount);
+            }
+        }
+    }
+
+    ColumnarBuffer_Flush(&buffer);
+
+    if (!buffer.failed && fflush(file) != 0) {
+        buffer.failed = 1;
+    }
+
+    free(chunkIds);
+    free(buffer.data);
+
+    return buffer.failed;
+}
@@ -0,0 +1,33 @@
+#ifndef IIS_LOG_COLUMNAR_H
+#define IIS_LOG_COLUMNAR_H
+
+#include "log_table.h"
+#include <stdio.h>
+
+// A columnar file keeps the table dictionary-encoded instead of re-serializing it as text.
+// All integers are little-endian, varints are unsigned LEB128 and signed numbers are zigzag encoded.
+//
+//   magic "IISLOGC\0", u32 version, u32 column count, u64 row count, u32 rows per chunk
+//   then for each column, one after the other:
+//     u8 name length, name, u8 LogColumnType, u8 1 for derived columns
+//     varint value count, then each value as a varint length and its bytes (value 0 is always "-")
+//     for number, date and time columns, each value's parsed number as a signed varint (-1 when invalid)
+//     then the row ids in chunks of rows per chunk, each one a u8 encoding, a varint byte count and the bytes
+//
+// Chunks are written with whichever encoding is smaller for them.
+#define LOG_COLUMNAR_MAGIC "IISLOGC"
+#define LOG_COLUMNAR_VERSION 1
+#define LOG_COLUMNAR_CHUNK_ROWS 65536
+
+typedef enum {
+    // Ids bit-packed least significant bit first, at the narrowest width that fits the value count.
+    LOG_COLUMNAR_ENCODING_PACKED,
+    // Varint run length followed by a varint id, repeated.
+    LOG_COLUMNAR_ENCODING_RUNS
+} LogColumnarEncoding;
+
+// Writes the given rows (every row when rows is 0), updating rowsWritten as columns are written
+// when it isn't 0. Returns 0 on success.
+int LogColumnar_Write(const LogTable* table, const uint32_t* rows, uint32_t rowCount, FILE* file, volatile uint32_t* rowsWritten);
+
+#endif
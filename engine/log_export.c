@@ -0,0 +1,292 @@
+#include "log_export.h"
+#include "log_columnar.h"
+#include "log_profile.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    char* data;
+    size_t used;
+    FILE* file;
+    int failed;
+} ExportBuffer;
+
+static void ExportBuffer_Flush(ExportBuffer* buffer) {
+    if (buffer->used > 0 && !buffer->failed && fwrite(buffer->data, 1, buffer->used, buffer->file) != buffer->used) {
+        buffer->failed = 1;
+    }
+
+    buffer->used = 0;
+}
+
+static void ExportBuffer_PutChar(ExportBuffer* buffer, char c) {
+    if (buffer->used == LOG_EXPORT_BATCH_SIZE) {
+        ExportBuffer_Flush(buffer);
+    }
+
+    buffer->data[buffer->used++] = c;
+}
+
+static void ExportBuffer_Append(ExportBuffer* buffer, const char* value, uint32_t length) {
+    if (buffer->used + length > LOG_EXPORT_BATCH_SIZE) {
+        ExportBuffer_Flush(buffer);
+
+        // Only a value longer than a whole batch bypasses the buffer.
+        if (length > LOG_EXPORT_BATCH_SIZE) {
+            if (!buffer->failed && fwrite(value, 1, length, buffer->file) != length) {
+                buffer->failed = 1;
+            }
+
+            return;
+        }
+    }
+
+    memcpy(buffer->data + buffer->used, value, length);
+    buffer->used += length;
+}
+
+static int NeedsCsvQuotes(const char* value, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        if (value[i] == ',' || value[i] == '"' || value[i] == '\n' || value[i] == '\r') {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int NeedsJsonEscaping(const char* value, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)value[i];
+
+        if (c == '"' || c == '\\' || c < 0x20) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void AppendCsvQuoted(ExportBuffer* buffer, const char* value, uint32_t length) {
+    ExportBuffer_PutChar(buffer, '"');
+
+    for (uint32_t i = 0; i < length; i++) {
+        if (value[i] == '"') {
+            ExportBuffer_PutChar(buffer, '"');
+        }
+
+        ExportBuffer_PutChar(buffer, value[i]);
+    }
+
+    ExportBuffer_PutChar(buffer, '"');
+}
+
+static void AppendJsonEscaped(ExportBuffer* buffer, const char* value, uint32_t length) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    for (uint32_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)value[i];
+
+        if (c == '"' || c == '\\') {
+            ExportBuffer_PutChar(buffer, '\\');
+            ExportBuffer_PutChar(buffer, (char)c);
+        } else if (c < 0x20) {
+            ExportBuffer_Append(buffer, "\\u00", 4);
+            ExportBuffer_PutChar(buffer, HEX_DIGITS[c >> 4]);
+            ExportBuffer_PutChar(buffer, HEX_DIGITS[c & 15]);
+        } else {
+            ExportBuffer_PutChar(buffer, (char)c);
+        }
+    }
+}
+
+// Whether each distinct value of a column needs escaping, so rows never scan their values for it.
+static uint8_t* FindEscapedValues(const LogDictionary* dictionary, LogExportFormat format) {
+    uint8_t* escaped = malloc(dictionary->count > 0 ? dictionary->count : 1);
+
+    if (escaped == 0) {
+        return 0;
+    }
+
+    for (uint32_t id = 0; id < dictionary->count; id++) {
+        escaped[id] = format == LOG_EXPORT_FORMAT_CSV ? (uint8_t)NeedsCsvQuotes(dictionary->values[id], dictionary->lengths[id])
+                                                     : (uint8_t)NeedsJsonEscaping(dictionary->values[id], dictionary->lengths[id]);
+    }
+
+    return escaped;
+}
+
+static void AppendValue(ExportBuffer* buffer, LogExportFormat format, const char* value, uint32_t length, int isEscaped) {
+    if (format == LOG_EXPORT_FORMAT_CSV) {
+        if (isEscaped) {
+            AppendCsvQuoted(buffer, value, length);
+        } else {
+            ExportBuffer_Append(buffer, value, length);
+        }
+    } else {
+        ExportBuffer_PutChar(buffer, '"');
+
+        if (isEscaped) {
+            AppendJsonEscaped(buffer, value, length);
+        } else {
+            ExportBuffer_Append(buffer, value, length);
+        }
+
+        ExportBuffer_PutChar(buffer, '"');
+    }
+}
+
+int LogExport_Write(const LogTable* table, const uint32_t* rows, uint32_t rowCount, LogExportFormat format, FILE* file, volatile uint32_t* rowsWritten) {
+    if (format == LOG_EXPORT_FORMAT_COLUMNAR) {
+        return LogColumnar_Write(table, rows, rowCount, file, rowsWritten);
+    }
+
+    if (rows == 0) {
+        rowCount = table->rowCount;
+    }
+
+    ExportBuffer buffer = { .data = malloc(LOG_EXPORT_BATCH_SIZE), .file = file };
+    uint8_t* escapedValues[LOG_TABLE_MAX_COLUMNS] = { 0 };
+    int result = buffer.data == 0;
+
+    for (int column = 0; column < table->columnCount && result == 0; column++) {
+        escapedValues[column] = FindEscapedValues(&table->columns[column].dictionary, format);
+        result = escapedValues[column] == 0;
+    }
+
+    if (result != 0) {
+        for (int column = 0; column < table->columnCount; column++) {
+            free(escapedValues[column]);
+        }
+
+        free(buffer.data);
+        return 1;
+    }
+
+    uint32_t nameLengths[LOG_TABLE_MAX_COLUMNS];
+    int escapedNames[LOG_TABLE_MAX_COLUMNS];
+
+    for (int column = 0; column < table->columnCount; column++) {
+        const char* name = table->columns[column].name;
+        nameLengths[column] = (uint32_t)strlen(name);
+        escapedNames[column] = format == LOG_EXPORT_FORMAT_CSV ? NeedsCsvQuotes(name, nameLengths[column]) : NeedsJsonEscaping(name, nameLengths[column]);
+
+        if (format == LOG_EXPORT_FORMAT_CSV) {
+            AppendValue(&buffer, format, name, nameLengths[column], escapedNames[column]);
+            ExportBuffer_PutChar(&buffer, column + 1 < table->columnCount ? ',' : '\n');
+        }
+    }
+
+    // Rows between progress updates, about one batch worth.
+    uint32_t progressInterval = 1 + LOG_EXPORT_BATCH_SIZE / (16 * (uint32_t)(table->columnCount > 0 ? table->columnCount : 1));
+
+    for (uint32_t i = 0; i < rowCount && !buffer.failed; i++) {
+        uint32_t row = rows ? rows[i] : i;
+
+        if (format == LOG_EXPORT_FORMAT_NDJSON) {
+            ExportBuffer_PutChar(&buffer, '{');
+        }
+
+        for (int column = 0; column < table->columnCount; column++) {
+            const LogColumn* logColumn = &table->columns[column];
+            uint32_t id = logColumn->ids[row];
+
+            if (format == LOG_EXPORT_FORMAT_NDJSON) {
+                AppendValue(&buffer, format, logColumn->name, nameLengths[column], escapedNames[column]);
+                ExportBuffer_PutChar(&buffer, ':');
+            }
+
+            AppendValue(&buffer, format, logColumn->dictionary.values[id], logColumn->dictionary.lengths[id], escapedValues[column][id]);
+
+            if (column + 1 < table->columnCount) {
+                ExportBuffer_PutChar(&buffer, ',');
+            }
+        }
+
+        if (format == LOG_EXPORT_FORMAT_NDJSON) {
+            ExportBuffer_PutChar(&buffer, '}');
+        }
+
+        ExportBuffer_PutChar(&buffer, '\n');
+
+        if (rowsWritten != 0 && i % progressInterval == 0) {
+            *rowsWritten = i;
+        }
+    }
+
+    ExportBuffer_Flush(&buffer);
+
+    if (!buffer.failed && fflush(file) != 0) {
+        buffer.failed = 1;
+    }
+
+    if (rowsWritten != 0 && !buffer.failed) {
+        *rowsWritten = rowCount;
+    }
+
+    for (int column = 0; column < table->columnCount; column++) {
+        free(escapedValues[column]);
+    }
+
+    free(buffer.data);
+
+    return buffer.failed;
+}
+
+static void RunExport(void* userData) {
+    LogExport* export = userData;
+
+    LOG_PROFILE(LOG_PROFILE_STAGE_EXPORT) {
+        FILE* file = fopen(export->path, "wb");
+
+        if (file == 0) {
+            export->result = 1;
+        } else {
+            export->result = LogExport_Write(export->table, export->rows, export->rowCount, export->format, file, &export->rowsWritten);
+
+            if (fclose(file) != 0) {
+                export->result = 1;
+            }
+        }
+    }
+
+    export->isDone = 1;
+}
+
+int LogExport_Start(LogExport* export, const LogTable* table, const uint32_t* rows, uint32_t rowCount, LogExportFormat format, const char* path) {
+    memset(export, 0, sizeof(*export));
+
+    if (rows == 0) {
+        rowCount = table->rowCount;
+    }
+
+    export->table = table;
+    export->format = format;
+    export->rowCount = rowCount;
+    export->rows = malloc((rowCount > 0 ? rowCount : 1) * sizeof(uint32_t));
+    snprintf(export->path, sizeof(export->path), "%s", path);
+
+    if (export->rows == 0) {
+        return 1;
+    }
+
+    for (uint32_t i = 0; i < rowCount; i++) {
+        export->rows[i] = rows ? rows[i] : i;
+    }
+
+    if (LogThread_Start(&export->thread, RunExport, export) != 0) {
+        free(export->rows);
+        export->rows = 0;
+        return 1;
+    }
+
+    return 0;
+}
+
+int LogExport_Finish(LogExport* export) {
+    LogThread_Join(export->thread);
+    free(export->rows);
+    export->rows = 0;
+
+    return export->result;
+}
@@ -0,0 +1,43 @@
+#ifndef IIS_LOG_EXPORT_H
+#define IIS_LOG_EXPORT_H
+
+#include "log_table.h"
+#include "log_thread.h"
+#include <stdio.h>
+
+// Rows are formatted into a buffer this large and written out in one call.
+#define LOG_EXPORT_BATCH_SIZE (4 << 20)
+#define LOG_EXPORT_PATH_LIMIT 4096
+
+typedef enum {
+    LOG_EXPORT_FORMAT_CSV,
+    LOG_EXPORT_FORMAT_NDJSON,
+    // Dictionary-encoded columns, see log_columnar.h.
+    LOG_EXPORT_FORMAT_COLUMNAR
+} LogExportFormat;
+
+// A background export of a set of rows to a file.
+typedef struct {
+    const LogTable* table;
+    LogExportFormat format;
+    // A copy of the rows, so the caller can filter again while the export runs.
+    uint32_t* rows;
+    uint32_t rowCount;
+    char path[LOG_EXPORT_PATH_LIMIT];
+    LogThread thread;
+    // Written by the export thread, read by anyone polling for progress.
+    volatile uint32_t rowsWritten;
+    volatile int isDone;
+    int result;
+} LogExport;
+
+// Writes the given rows (every row when rows is 0) with a header, updating rowsWritten after each
+// batch when it isn't 0. Returns 0 on success.
+int LogExport_Write(const LogTable* table, const uint32_t* rows, uint32_t rowCount, LogExportFormat format, FILE* file, volatile uint32_t* rowsWritten);
+
+// Starts writing the rows to path on a worker thread. Returns 0 when the export was started.
+int LogExport_Start(LogExport* export, const LogTable* table, const uint32_t* rows, uint32_t rowCount, LogExportFormat format, const char* path);
+// Waits for the export to end and releases it. Returns 0 when every row was written.
+int LogExport_Finish(LogExport* export);
+
+#endif
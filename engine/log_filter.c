@@ -0,0 +1,546 @@
+#include "log_filter.h"
+#include "log_regex.h"
+#include "log_aho_corasick.h"
+#include <stdio.h>
+#include <assert.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_FILTER_MAX_TOKENS 4
+
+const char* strstr_insensitive(const char* haystack, const char* needle) {
+    assert(haystack != 0);
+    assert(needle != 0);
+
+    const char* foundPtr = 0;
+
+    const char* haystackPtr = haystack;
+    const char* needlePtr = needle;
+
+    while (*haystackPtr != '\0') {
+        if (tolower(*haystackPtr) == tolower(*needlePtr)) {
+            if (foundPtr == 0) {
+                foundPtr = haystackPtr;
+            }
+
+            needlePtr++;
+
+            if (*needlePtr == '\0') {
+                break;
+            }
+        } else if (foundPtr != 0) {
+            foundPtr = 0;
+            needlePtr = needle;
+        }
+
+        haystackPtr++;
+    }
+
+    if (*needlePtr != '\0') {
+        return 0;
+    }
+
+    return foundPtr;
+}
+
+static int CompileValueSet(LogFilter* filter, const LogTable* table, int column) {
+    filter->type = LOG_FILTER_TYPE_VALUE_SET;
+    filter->column = column;
+    filter->matchingIds = calloc(column >= 0 ? table->columns[column].dictionary.count : 1, sizeof(uint8_t));
+
+    return filter->matchingIds == 0;
+}
+
+static int CompileAddressPrefix(LogFilter* filter, const LogTable* table, const char* cidr, uint32_t cidrLength) {
+    if (CompileValueSet(filter, table, table->clientIpColumn) != 0) {
+        return 1;
+    }
+
+    LogAddress prefix;
+    int prefixLength;
+
+    if (table->clientIpColumn < 0 || LogAddress_ParseCidr(cidr, cidrLength, &prefix, &prefixLength) != 0) {
+        return 1;
+    }
+
+    LogAddressTrie_MarkPrefix(&table->clientTrie, &prefix, prefixLength, filter->matchingIds);
+
+    return 0;
+}
+
+static int FindColumn(const LogTable* table, const char* columnName, uint32_t columnNameLength) {
+    char name[LOG_COLUMN_NAME_LIMIT] = { 0 };
+
+    if (columnNameLength >= LOG_COLUMN_NAME_LIMIT) {
+        columnNameLength = LOG_COLUMN_NAME_LIMIT - 1;
+    }
+
+    memcpy(name, columnName, columnNameLength);
+    return LogTable_FindColumn(table, name);
+}
+
+static int CompileEquality(LogFilter* filter, const LogTable* table, const char* columnName, uint32_t columnNameLength, const char* value, uint32_t valueLength, int negate) {
+    int column = FindColumn(table, columnName, columnNameLength);
+
+    if (CompileValueSet(filter, table, column) != 0 || column < 0) {
+        return 1;
+    }
+
+    const LogDictionary* dictionary = &table->columns[column].dictionary;
+    int64_t id = LogDictionary_Find(dictionary, value, valueLength);
+
+    if (negate) {
+        memset(filter->matchingIds, 1, dictionary->count);
+    }
+
+    if (id >= 0) {
+        filter->matchingIds[id] = !negate;
+    }
+
+    return 0;
+}
+
+// The regex runs once per distinct value of a column, rows then only look their ids up like an equality.
+// With column -1 every column gets its own set. A malformed pattern leaves its error in filter->text.
+static int CompileRegex(LogFilter* filter, const LogTable* table, int column, const char* pattern, int negate) {
+    char trimmed[LOG_FILTER_TEXT_LIMIT] = { 0 };
+    size_t length = strlen(pattern);
+
+    while (length > 0 && pattern[length - 1] == ' ') {
+        length--;
+    }
+
+    memcpy(trimmed, pattern, length < LOG_FILTER_TEXT_LIMIT ? length : LOG_FILTER_TEXT_LIMIT - 1);
+
+    if (column >= 0) {
+        if (CompileValueSet(filter, table, column) != 0) {
+            return 1;
+        }
+    } else {
+        filter->type = LOG_FILTER_TYPE_ANY_VALUE_SET;
+    }
+
+    LogRegex regex;
+
+    if (LogRegex_Compile(&regex, trimmed) != 0) {
+        strncpy(filter->text, regex.error, LOG_FILTER_TEXT_LIMIT - 1);
+        LogRegex_Free(&regex);
+        return 1;
+    }
+
+    int result = 0;
+
+    for (int current = 0; current < table->columnCount; current++) {
+        // Without a column only what's in the log is searched, not the columns derived from it.
+        if ((column >= 0 && current != column) || (column < 0 && table->columns[current].isDerived)) {
+            continue;
+        }
+
+        const LogDictionary* dictionary = &table->columns[current].dictionary;
+        uint8_t* matchingIds = column >= 0 ? filter->matchingIds : calloc(dictionary->count, sizeof(uint8_t));
+        int anyMatches = 0;
+
+        if (matchingIds == 0) {
+            result = 1;
+            break;
+        }
+
+        for (uint32_t id = 0; id < dictionary->count; id++) {
+            matchingIds[id] = (uint8_t)(LogRegex_Matches(&regex, dictionary->values[id], dictionary->lengths[id]) != negate);
+            anyMatches |= matchingIds[id];
+        }
+
+        // Columns where nothing matches aren't looked at per row.
+        if (column < 0) {
+            if (anyMatches) {
+                filter->columnMatchingIds[current] = matchingIds;
+            } else {
+                free(matchingIds);
+            }
+        }
+    }
+
+    LogRegex_Free(&regex);
+
+    return result;
+}
+
+// Reads the whole file into a NUL-terminated buffer, or returns 0.
+static char* ReadPatternFile(const char* path) {
+    FILE* file = fopen(path, "rb");
+
+    if (file == 0) {
+        return 0;
+    }
+
+    size_t capacity = 4096;
+    size_t length = 0;
+    char* text = malloc(capacity);
+
+    while (text != 0) {
+        length += fread(text + length, 1, capacity - length - 1, file);
+
+        if (length < capacity - 1) {
+            break;
+        }
+
+        char* grown = realloc(text, capacity * 2);
+
+        if (grown == 0) {
+            free(text);
+        }
+
+        text = grown;
+        capacity *= 2;
+    }
+
+    fclose(file);
+
+    if (text != 0) {
+        text[length] = '\0';
+    }
+
+    return text;
+}
+
+static void KeepFirstPattern(int pattern, uint64_t end, void* userData) {
+    (void)end;
+    int32_t* first = userData;
+
+    if (*first < 0 || pattern < *first) {
+        *first = pattern;
+    }
+}
+
+// Splits the list, or the file after @, into patterns and scans every distinct value of the column once
+// with an Aho-Corasick automaton over all of them. With column -1 every column gets its own set.
+static int CompilePatterns(LogFilter* filter, const LogTable* table, int column, const char* list) {
+    char trimmed[LOG_FILTER_TEXT_LIMIT] = { 0 };
+    size_t length = strlen(list);
+
+    while (length > 0 && list[length - 1] == ' ') {
+        length--;
+    }
+
+    memcpy(trimmed, list, length < LOG_FILTER_TEXT_LIMIT ? length : LOG_FILTER_TEXT_LIMIT - 1);
+
+    if (column >= 0) {
+        if (CompileValueSet(filter, table, column) != 0) {
+            return 1;
+        }
+    } else {
+        filter->type = LOG_FILTER_TYPE_ANY_VALUE_SET;
+    }
+
+    int isFile = trimmed[0] == '@';
+    filter->patternText = isFile ? ReadPatternFile(trimmed + 1) : malloc(strlen(trimmed) + 1);
+
+    if (filter->patternText == 0) {
+        if (isFile) {
+            const char* message = "unable to read ";
+            int pathLimit = LOG_FILTER_TEXT_LIMIT - 1 - (int)strlen(message);
+            snprintf(filter->text, LOG_FILTER_TEXT_LIMIT, "%s%.*s", message, pathLimit, trimmed + 1);
+        } else {
+            strcpy(filter->text, "out of memory");
+        }
+
+        return 1;
+    }
+
+    if (!isFile) {
+        strcpy(filter->patternText, trimmed);
+    }
+
+    // Patterns are split in place, by spaces in a list and by lines in a file.
+    const char* separators = isFile ? "\r\n" : " ";
+    size_t patternCapacity = 16;
+    uint32_t* lengths = malloc(patternCapacity * sizeof(uint32_t));
+    filter->patterns = malloc(patternCapacity * sizeof(char*));
+
+    for (char* cursor = filter->patternText; *cursor != '\0' && filter->patterns != 0 && lengths != 0; ) {
+        size_t patternLength = strcspn(cursor, separators);
+        char* pattern = cursor;
+        cursor += patternLength + (cursor[patternLength] != '\0');
+        pattern[patternLength] = '\0';
+
+        if (patternLength == 0 || (isFile && pattern[0] == '#')) {
+            continue;
+        }
+
+        if ((size_t)filter->patternCount == patternCapacity) {
+            patternCapacity *= 2;
+            char** patterns = realloc(filter->patterns, patternCapacity * sizeof(char*));
+            uint32_t* grownLengths = realloc(lengths, patternCapacity * sizeof(uint32_t));
+
+            if (patterns != 0) {
+                filter->patterns = patterns;
+            }
+
+            if (grownLengths != 0) {
+                lengths = grownLengths;
+            }
+
+            if (patterns == 0 || grownLengths == 0) {
+                break;
+            }
+        }
+
+        filter->patterns[filter->patternCount] = pattern;
+        lengths[filter->patternCount++] = (uint32_t)patternLength;
+    }
+
+    LogAhoCorasick automaton;
+
+    if (filter->patterns == 0 || lengths == 0 || filter->patternCount == 0 ||
+        LogAhoCorasick_Build(&automaton, (const char* const*)filter->patterns, lengths, filter->patternCount) != 0) {
+        snprintf(filter->text, LOG_FILTER_TEXT_LIMIT, "%s", filter->patternCount == 0 ? "no patterns" : "out of memory");
+        free(lengths);
+        return 1;
+    }
+
+    free(lengths);
+    int result = 0;
+
+    for (int current = 0; current < table->columnCount; current++) {
+        // Without a column only what's in the log is searched, not the columns derived from it.
+        if ((column >= 0 && current != column) || (column < 0 && table->columns[current].isDerived)) {
+            continue;
+        }
+
+        const LogDictionary* dictionary = &table->columns[current].dictionary;
+        uint8_t* matchingIds = column >= 0 ? filter->matchingIds : calloc(dictionary->count, sizeof(uint8_t));
+        int32_t* patterns = malloc((dictionary->count + 1) * sizeof(int32_t));
+        int anyMatches = 0;
+
+        if (matchingIds == 0 || patterns == 0) {
+            if (column < 0) {
+                free(matchingIds);
+            }
+
+            free(patterns);
+            result = 1;
+            break;
+        }
+
+        for (uint32_t id = 0; id < dictionary->count; id++) {
+            patterns[id] = -1;
+            LogAhoCorasick_Scan(&automaton, 0, dictionary->values[id], dictionary->lengths[id], KeepFirstPattern, &patterns[id]);
+            matchingIds[id] = patterns[id] >= 0;
+            anyMatches |= matchingIds[id];
+        }
+
+        // Columns where nothing matches aren't looked at per row.
+        if (anyMatches || column >= 0) {
+            filter->columnPatterns[current] = patterns;
+
+            if (column < 0) {
+                filter->columnMatchingIds[current] = matchingIds;
+            }
+        } else {
+            free(matchingIds);
+            free(patterns);
+        }
+    }
+
+    LogAhoCorasick_Free(&automaton);
+
+    return result;
+}
+
+int LogFilter_Compile(LogFilter* filter, const LogTable* table, const char* expression) {
+    memset(filter, 0, sizeof(*filter));
+    filter->column = -1;
+
+    const char* tokens[LOG_FILTER_MAX_TOKENS] = { 0 };
+    uint32_t tokenLengths[LOG_FILTER_MAX_TOKENS] = { 0 };
+    int tokenCount = 0;
+    const char* cursor = expression;
+
+    while (*cursor != '\0') {
+        while (*cursor == ' ') {
+            cursor++;
+        }
+
+        if (*cursor == '\0') {
+            break;
+        }
+
+        if (tokenCount == LOG_FILTER_MAX_TOKENS) {
+            tokenCount++;
+            break;
+        }
+
+        tokens[tokenCount] = cursor;
+
+        while (*cursor != '\0' && *cursor != ' ') {
+            cursor++;
+        }
+
+        tokenLengths[tokenCount] = (uint32_t)(cursor - tokens[tokenCount]);
+        tokenCount++;
+    }
+
+    if (tokenCount == 0) {
+        filter->type = LOG_FILTER_TYPE_ALL;
+        return 0;
+    }
+
+    // A pattern can have spaces, it's the rest of the expression.
+    if (tokenCount >= 2 && tokenLengths[0] == 1 && tokens[0][0] == '~') {
+        return CompileRegex(filter, table, -1, tokens[1], 0);
+    }
+
+    if (tokenCount >= 3 && ((tokenLengths[1] == 1 && tokens[1][0] == '~') || (tokenLengths[1] == 2 && strncmp(tokens[1], "!~", 2) == 0))) {
+        int column = FindColumn(table, tokens[0], tokenLengths[0]);
+
+        if (column < 0) {
+            CompileValueSet(filter, table, column);
+            return 1;
+        }
+
+        return CompileRegex(filter, table, column, tokens[2], tokenLengths[1] == 2);
+    }
+
+    if (tokenCount >= 2 && tokenLengths[0] == 3 && strncmp(tokens[0], "any", 3) == 0) {
+        return CompilePatterns(filter, table, -1, tokens[1]);
+    }
+
+    if (tokenCount >= 3 && tokenLengths[1] == 3 && strncmp(tokens[1], "any", 3) == 0) {
+        int column = FindColumn(table, tokens[0], tokenLengths[0]);
+
+        if (column < 0) {
+            CompileValueSet(filter, table, column);
+            return 1;
+        }
+
+        return CompilePatterns(filter, table, column, tokens[2]);
+    }
+
+    if (tokenCount == 3 && tokenLengths[0] == 4 && strncmp(tokens[0], "c-ip", 4) == 0 && tokenLengths[1] == 2 && strncmp(tokens[1], "in", 2) == 0) {
+        return CompileAddressPrefix(filter, table, tokens[2], tokenLengths[2]);
+    }
+
+    if (tokenCount == 3 && tokenLengths[1] == 1 && tokens[1][0] == '=') {
+        return CompileEquality(filter, table, tokens[0], tokenLengths[0], tokens[2], tokenLengths[2], 0);
+    }
+
+    if (tokenCount == 3 && tokenLengths[1] == 2 && strncmp(tokens[1], "!=", 2) == 0) {
+        return CompileEquality(filter, table, tokens[0], tokenLengths[0], tokens[2], tokenLengths[2], 1);
+    }
+
+    filter->type = LOG_FILTER_TYPE_SUBSTRING;
+    strncpy(filter->text, expression, LOG_FILTER_TEXT_LIMIT - 1);
+
+    return 0;
+}
+
+void LogFilter_Free(LogFilter* filter) {
+    free(filter->matchingIds);
+
+    for (int column = 0; column < LOG_TABLE_MAX_COLUMNS; column++) {
+        free(filter->columnMatchingIds[column]);
+        free(filter->columnPatterns[column]);
+    }
+
+    free(filter->patterns);
+    free(filter->patternText);
+
+    memset(filter, 0, sizeof(*filter));
+}
+
+int LogFilter_MatchesRow(const LogFilter* filter, const LogTable* table, uint32_t row) {
+    switch (filter->type) {
+        case LOG_FILTER_TYPE_ALL:
+            return 1;
+        case LOG_FILTER_TYPE_SUBSTRING: {
+            for (int column = 0; column < table->columnCount; column++) {
+                if (!table->columns[column].isDerived && strstr_insensitive(LogTable_GetValue(table, column, row), filter->text)) {
+                    return 1;
+                }
+            }
+
+            return 0;
+        }
+        case LOG_FILTER_TYPE_VALUE_SET:
+            return filter->column >= 0 && filter->matchingIds[LogTable_GetId(table, filter->column, row)];
+        case LOG_FILTER_TYPE_ANY_VALUE_SET: {
+            for (int column = 0; column < table->columnCount; column++) {
+                if (filter->columnMatchingIds[column] != 0 && filter->columnMatchingIds[column][LogTable_GetId(table, column, row)]) {
+                    return 1;
+                }
+            }
+
+            return 0;
+        }
+        default:
+            return 0;
+    }
+}
+
+int LogFilter_GetPattern(const LogFilter* filter, const LogTable* table, uint32_t row) {
+    int first = -1;
+
+    for (int column = 0; column < table->columnCount && filter->patternCount > 0; column++) {
+        if (filter->columnPatterns[column] != 0) {
+            int pattern = filter->columnPatterns[column][LogTable_GetId(table, column, row)];
+            first = pattern >= 0 && (first < 0 || pattern < first) ? pattern : first;
+        }
+    }
+
+    return first;
+}
+
+uint32_t LogFilter_Apply(const LogFilter* filter, const LogTable* table, uint32_t* outRows) {
+    uint32_t count = 0;
+
+    if (filter->type == LOG_FILTER_TYPE_VALUE_SET) {
+        if (filter->column < 0) {
+            return 0;
+        }
+
+        // One byte lookup per row, no string is touched.
+        const uint32_t* ids = table->columns[filter->column].ids;
+
+        for (uint32_t row = 0; row < table->rowCount; row++) {
+            outRows[count] = row;
+            count += filter->matchingIds[ids[row]];
+        }
+
+        return count;
+    }
+
+    if (filter->type == LOG_FILTER_TYPE_ANY_VALUE_SET) {
+        const uint32_t* ids[LOG_TABLE_MAX_COLUMNS];
+        const uint8_t* matchingIds[LOG_TABLE_MAX_COLUMNS];
+        int columnCount = 0;
+
+        for (int column = 0; column < table->columnCount; column++) {
+            if (filter->columnMatchingIds[column] != 0) {
+                ids[columnCount] = table->columns[column].ids;
+                matchingIds[columnCount++] = filter->columnMatchingIds[column];
+            }
+        }
+
+        for (uint32_t row = 0; row < table->rowCount && columnCount > 0; row++) {
+            uint8_t matches = 0;
+
+            for (int i = 0; i < columnCount; i++) {
+                matches |= matchingIds[i][ids[i][row]];
+            }
+
+            outRows[count] = row;
+            count += matches;
+        }
+
+        return count;
+    }
+
+    for (uint32_t row = 0; row < table->rowCount; row++) {
+        if (LogFilter_MatchesRow(filter, table, row)) {
+            outRows[count++] = row;
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,57 @@
+#ifndef IIS_LOG_FILTER_H
+#define IIS_LOG_FILTER_H
+
+#include "log_table.h"
+
+#define LOG_FILTER_TEXT_LIMIT 2048
+
+typedef enum {
+    LOG_FILTER_TYPE_ALL,
+    // Case-insensitive substring of any cell in the row.
+    LOG_FILTER_TYPE_SUBSTRING,
+    // Rows whose value in one column is in a precomputed set of dictionary ids.
+    LOG_FILTER_TYPE_VALUE_SET,
+    // Rows whose value in any of the columns is in that column's precomputed set.
+    LOG_FILTER_TYPE_ANY_VALUE_SET
+} LogFilterType;
+
+typedef struct {
+    LogFilterType type;
+    char text[LOG_FILTER_TEXT_LIMIT];
+    int column;
+    uint8_t* matchingIds;
+    // Per column for LOG_FILTER_TYPE_ANY_VALUE_SET, 0 for columns without a matching value.
+    uint8_t* columnMatchingIds[LOG_TABLE_MAX_COLUMNS];
+    // Pattern lists: the patterns, and per column the first of them each dictionary value contains, or -1.
+    char** patterns;
+    int patternCount;
+    char* patternText;
+    int32_t* columnPatterns[LOG_TABLE_MAX_COLUMNS];
+} LogFilter;
+
+// Supported expressions:
+//   (empty)               every row
+//   c-ip in 10.0.0.0/8    rows whose client address is inside the prefix (IPv4 or IPv6)
+//   route = /api/{id}     rows whose value in the column is exactly the given one, != negates
+//   ~ /api/v[12]/\d+      rows with a cell matching the regular expression (see log_regex.h)
+//   route ~ ^/api/        rows whose value in the column matches it, !~ negates
+//   any /.env /wp-login   rows with a cell containing any of the patterns, case-insensitive, in one pass
+//   c-ip any @blocked.txt rows whose value in the column contains any of the patterns in the file, one per
+//                         line, # starts a comment
+//   anything else         case-insensitive substring of any cell
+// Searches that don't name a column only look at the fields of the log. Derived columns have to be
+// named, like agent = bot for the class of the user agent.
+// Returns 0 on success. A malformed expression still leaves a usable filter that matches nothing.
+int LogFilter_Compile(LogFilter* filter, const LogTable* table, const char* expression);
+void LogFilter_Free(LogFilter* filter);
+
+int LogFilter_MatchesRow(const LogFilter* filter, const LogTable* table, uint32_t row);
+// Index into filter->patterns of the first pattern the row contains, or -1 when it has none or the
+// filter isn't a pattern list.
+int LogFilter_GetPattern(const LogFilter* filter, const LogTable* table, uint32_t row);
+// Writes the indexes of the matching rows, outRows needs room for table->rowCount. Returns the count.
+uint32_t LogFilter_Apply(const LogFilter* filter, const LogTable* table, uint32_t* outRows);
+
+const char* strstr_insensitive(const char* haystack, const char* needle);
+
+#endif
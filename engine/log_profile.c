@@ -0,0 +1,160 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "log_profile.h"
+#include "log_trace.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+static const char* STAGE_NAMES[LOG_PROFILE_STAGE_COUNT] = {
+    "frame", "input", "declare", "layout", "render", "search", "tables", "load", "export"
+};
+
+static const char* COUNTER_NAMES[LOG_PROFILE_COUNTER_COUNT] = {
+    "render commands", "elements", "rows scanned"
+};
+
+static LogProfileTimer timers[LOG_PROFILE_STAGE_COUNT];
+static uint64_t counters[LOG_PROFILE_COUNTER_COUNT];
+
+uint64_t LogProfile_Now(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)(counter.QuadPart / frequency.QuadPart * 1000000 + counter.QuadPart % frequency.QuadPart * 1000000 / frequency.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+#endif
+}
+
+static int BucketOf(uint32_t microseconds) {
+    int bucket = 0;
+
+    while (microseconds >= 2 && bucket < LOG_PROFILE_BUCKET_COUNT - 1) {
+        microseconds >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+void LogProfile_Record(LogProfileStage stage, uint64_t microseconds) {
+    LogProfileTimer* timer = &timers[stage];
+    uint32_t sample = microseconds < UINT32_MAX ? (uint32_t)microseconds : UINT32_MAX;
+
+    // The histogram covers the window, so the sample falling out of it leaves its bucket.
+    if (timer->sampleCount == LOG_PROFILE_WINDOW) {
+        timer->histogram[BucketOf(timer->samples[timer->next])]--;
+    } else {
+        timer->sampleCount++;
+    }
+
+    timer->samples[timer->next] = sample;
+    timer->histogram[BucketOf(sample)]++;
+    timer->next = (timer->next + 1) % LOG_PROFILE_WINDOW;
+    timer->totalCount++;
+}
+
+// Stages show up in the trace as well, under their own names.
+void LogProfile_End(LogProfileStage stage, uint64_t start) {
+    uint64_t end = LogProfile_Now();
+    LogProfile_Record(stage, end - start);
+    LogTrace_Record(STAGE_NAMES[stage], start, end);
+}
+
+void LogProfile_SetCounter(LogProfileCounter counter, uint64_t value) {
+    counters[counter] = value;
+}
+
+uint64_t LogProfile_GetCounter(LogProfileCounter counter) {
+    return counters[counter];
+}
+
+const LogProfileTimer* LogProfile_GetTimer(LogProfileStage stage) {
+    return &timers[stage];
+}
+
+static int CompareSamples(const void* a, const void* b) {
+    uint32_t left = *(const uint32_t*)a;
+    uint32_t right = *(const uint32_t*)b;
+
+    return (left > right) - (left < right);
+}
+
+LogProfileSummary LogProfile_Summarize(LogProfileStage stage) {
+    const LogProfileTimer* timer = &timers[stage];
+    LogProfileSummary summary = { .count = timer->sampleCount };
+
+    if (timer->sampleCount == 0) {
+        return summary;
+    }
+
+    uint32_t sorted[LOG_PROFILE_WINDOW];
+    uint64_t total = 0;
+    memcpy(sorted, timer->samples, timer->sampleCount * sizeof(uint32_t));
+
+    for (uint32_t i = 0; i < timer->sampleCount; i++) {
+        total += sorted[i];
+    }
+
+    qsort(sorted, timer->sampleCount, sizeof(uint32_t), CompareSamples);
+    summary.last = timer->samples[(timer->next + LOG_PROFILE_WINDOW - 1) % LOG_PROFILE_WINDOW];
+    summary.mean = (uint32_t)(total / timer->sampleCount);
+    summary.p50 = sorted[(timer->sampleCount - 1) / 2];
+    summary.p95 = sorted[(timer->sampleCount - 1) * 95 / 100];
+    summary.max = sorted[timer->sampleCount - 1];
+
+    return summary;
+}
+
+const char* LogProfile_StageName(LogProfileStage stage) {
+    return STAGE_NAMES[stage];
+}
+
+const char* LogProfile_CounterName(LogProfileCounter counter) {
+    return COUNTER_NAMES[counter];
+}
+
+int LogProfile_Dump(FILE* file) {
+    fprintf(file, "stage,samples,last us,mean us,p50 us,p95 us,max us");
+
+    for (int bucket = 0; bucket < LOG_PROFILE_BUCKET_COUNT; bucket++) {
+        if (bucket < LOG_PROFILE_BUCKET_COUNT - 1) {
+            fprintf(file, ",<%lu us", 2ul << bucket);
+        } else {
+            fprintf(file, ",>=%lu us", 1ul << bucket);
+        }
+    }
+
+    fputc('\n', file);
+
+    for (int stage = 0; stage < LOG_PROFILE_STAGE_COUNT; stage++) {
+        LogProfileSummary summary = LogProfile_Summarize((LogProfileStage)stage);
+        fprintf(file, "%s,%u,%u,%u,%u,%u,%u", STAGE_NAMES[stage], summary.count, summary.last, summary.mean, summary.p50, summary.p95, summary.max);
+
+        for (int bucket = 0; bucket < LOG_PROFILE_BUCKET_COUNT; bucket++) {
+            fprintf(file, ",%u", timers[stage].histogram[bucket]);
+        }
+
+        fputc('\n', file);
+    }
+
+    fprintf(file, "\ncounter,value\n");
+
+    for (int counter = 0; counter < LOG_PROFILE_COUNTER_COUNT; counter++) {
+        fprintf(file, "%s,%llu\n", COUNTER_NAMES[counter], (unsigned long long)counters[counter]);
+    }
+
+    return ferror(file) != 0;
+}
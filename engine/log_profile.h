@@ -0,0 +1,74 @@
+#ifndef IIS_LOG_PROFILE_H
+#define IIS_LOG_PROFILE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Samples each stage keeps, about four seconds of frames at 60 fps.
+#define LOG_PROFILE_WINDOW 240
+// Bucket b of a histogram counts samples of 2^b up to 2^(b+1) microseconds, the last one everything slower.
+#define LOG_PROFILE_BUCKET_COUNT 21
+
+typedef enum {
+    LOG_PROFILE_STAGE_FRAME,
+    LOG_PROFILE_STAGE_INPUT,
+    LOG_PROFILE_STAGE_DECLARE,
+    LOG_PROFILE_STAGE_LAYOUT,
+    LOG_PROFILE_STAGE_RENDER,
+    LOG_PROFILE_STAGE_SEARCH,
+    LOG_PROFILE_STAGE_TABLES,
+    LOG_PROFILE_STAGE_LOAD,
+    LOG_PROFILE_STAGE_EXPORT,
+    LOG_PROFILE_STAGE_COUNT
+} LogProfileStage;
+
+typedef enum {
+    LOG_PROFILE_COUNTER_RENDER_COMMANDS,
+    LOG_PROFILE_COUNTER_ELEMENTS,
+    LOG_PROFILE_COUNTER_ROWS_SCANNED,
+    LOG_PROFILE_COUNTER_COUNT
+} LogProfileCounter;
+
+// The last LOG_PROFILE_WINDOW durations of a stage in microseconds, oldest first from next once it's full.
+typedef struct {
+    uint32_t samples[LOG_PROFILE_WINDOW];
+    uint32_t sampleCount;
+    uint32_t next;
+    uint64_t totalCount;
+    uint32_t histogram[LOG_PROFILE_BUCKET_COUNT];
+} LogProfileTimer;
+
+// Over the samples in the window, in microseconds.
+typedef struct {
+    uint32_t count;
+    uint32_t last;
+    uint32_t mean;
+    uint32_t p50;
+    uint32_t p95;
+    uint32_t max;
+} LogProfileSummary;
+
+// Times the statement or block after it as the given stage, the same way CLAY() wraps its children.
+// Leaving the block with break, goto or return skips the sample.
+#define LOG_PROFILE(stage) \
+    for (uint64_t logProfileStart = LogProfile_Now(), logProfileOnce = 1; logProfileOnce; logProfileOnce = 0, LogProfile_End((stage), logProfileStart))
+
+// Microseconds on a monotonic clock.
+uint64_t LogProfile_Now(void);
+
+// The profile is shared by the whole process. Each stage has to be recorded from one thread at a time,
+// reading it from another one can see a sample half added, which is only ever off for that sample.
+void LogProfile_Record(LogProfileStage stage, uint64_t microseconds);
+void LogProfile_End(LogProfileStage stage, uint64_t start);
+void LogProfile_SetCounter(LogProfileCounter counter, uint64_t value);
+uint64_t LogProfile_GetCounter(LogProfileCounter counter);
+
+const LogProfileTimer* LogProfile_GetTimer(LogProfileStage stage);
+LogProfileSummary LogProfile_Summarize(LogProfileStage stage);
+const char* LogProfile_StageName(LogProfileStage stage);
+const char* LogProfile_CounterName(LogProfileCounter counter);
+
+// Writes a CSV line per stage with its summary and histogram, then one per counter. Returns 0 on success.
+int LogProfile_Dump(FILE* file);
+
+#endif
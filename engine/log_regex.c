@@ -0,0 +1,857 @@
+#include "log_regex.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_REGEX_MAX_REPEAT 1000
+#define LOG_REGEX_BUCKET_COUNT (LOG_REGEX_MAX_STATES * 2)
+#define LOG_REGEX_FULL (-2)
+
+#define LOG_REGEX_STATE_MATCH 1
+#define LOG_REGEX_STATE_MATCH_AT_END 2
+#define LOG_REGEX_STATE_DEAD 4
+#define LOG_REGEX_STATE_AT_START 8
+
+// Part of the NFA with one way in and one dangling way out, the out of its end node.
+typedef struct {
+    int32_t start;
+    int32_t end;
+} LogRegexFragment;
+
+static const LogRegexFragment LOG_REGEX_INVALID = { -1, -1 };
+
+typedef struct {
+    LogRegex* regex;
+    const char* cursor;
+    const char* end;
+    // Only the outermost concatenation looks for the required literal.
+    int isTopLevel;
+    char run[LOG_REGEX_LITERAL_LIMIT];
+    uint32_t runLength;
+    // Lowercased byte the last atom matches when it matches a single one, or -1.
+    int atomLiteral;
+} LogRegexParser;
+
+static LogRegexFragment ParseAlternation(LogRegexParser* parser);
+
+static LogRegexFragment Fail(LogRegex* regex, const char* message) {
+    if (regex->error[0] == '\0') {
+        snprintf(regex->error, sizeof(regex->error), "%s", message);
+    }
+
+    return LOG_REGEX_INVALID;
+}
+
+static int32_t AddNode(LogRegex* regex, LogRegexNodeType type, int32_t out, int32_t out1, int32_t set) {
+    if (regex->nodeCount == LOG_REGEX_MAX_NODES) {
+        Fail(regex, "pattern is too large");
+        return -1;
+    }
+
+    regex->nodes[regex->nodeCount] = (LogRegexNode){ .type = type, .out = out, .out1 = out1, .set = set };
+    return regex->nodeCount++;
+}
+
+static uint8_t* AddSet(LogRegex* regex, int32_t* index) {
+    if (regex->setCount == LOG_REGEX_MAX_NODES) {
+        Fail(regex, "pattern is too large");
+        return 0;
+    }
+
+    *index = regex->setCount++;
+    memset(regex->sets[*index], 0, sizeof(regex->sets[*index]));
+    return regex->sets[*index];
+}
+
+static inline int SetHas(const uint8_t* set, int c) {
+    return (set[c >> 3] >> (c & 7)) & 1;
+}
+
+static inline void SetAdd(uint8_t* set, int c) {
+    set[c >> 3] |= (uint8_t)(1 << (c & 7));
+}
+
+static void SetAddRange(uint8_t* set, int low, int high) {
+    for (int c = low; c <= high; c++) {
+        SetAdd(set, c);
+    }
+}
+
+// Searches are case-insensitive, a letter in the set brings the other case with it.
+static void SetFoldCase(uint8_t* set) {
+    for (int c = 'a'; c <= 'z'; c++) {
+        if (SetHas(set, c) || SetHas(set, toupper(c))) {
+            SetAdd(set, c);
+            SetAdd(set, toupper(c));
+        }
+    }
+}
+
+// Adds \d \w \s and their negations to the set, returns 0 when escape isn't one of them.
+static int SetAddClass(uint8_t* set, char escape) {
+    uint8_t class[LOG_REGEX_ALPHABET / 8] = { 0 };
+
+    switch (tolower((unsigned char)escape)) {
+        case 'd':
+            SetAddRange(class, '0', '9');
+            break;
+        case 'w':
+            SetAddRange(class, '0', '9');
+            SetAddRange(class, 'a', 'z');
+            SetAddRange(class, 'A', 'Z');
+            SetAdd(class, '_');
+            break;
+        case 's':
+            SetAdd(class, ' ');
+            SetAddRange(class, '\t', '\r');
+            break;
+        default:
+            return 0;
+    }
+
+    int negate = isupper((unsigned char)escape);
+
+    for (size_t i = 0; i < sizeof(class); i++) {
+        set[i] |= negate ? (uint8_t)~class[i] : class[i];
+    }
+
+    return 1;
+}
+
+static char Unescape(char escape) {
+    return escape == 'n' ? '\n' : escape == 't' ? '\t' : escape == 'r' ? '\r' : escape;
+}
+
+static LogRegexFragment Fragment_Node(LogRegex* regex, LogRegexNodeType type, int32_t set) {
+    int32_t node = AddNode(regex, type, -1, -1, set);
+    return node < 0 ? LOG_REGEX_INVALID : (LogRegexFragment){ node, node };
+}
+
+static LogRegexFragment Fragment_Concat(LogRegex* regex, LogRegexFragment first, LogRegexFragment second) {
+    if (first.start < 0 || second.start < 0) {
+        return LOG_REGEX_INVALID;
+    }
+
+    regex->nodes[first.end].out = second.start;
+    return (LogRegexFragment){ first.start, second.end };
+}
+
+static LogRegexFragment Fragment_Alternate(LogRegex* regex, LogRegexFragment first, LogRegexFragment second) {
+    if (first.start < 0 || second.start < 0) {
+        return LOG_REGEX_INVALID;
+    }
+
+    int32_t end = AddNode(regex, LOG_REGEX_NODE_JUMP, -1, -1, -1);
+    int32_t split = AddNode(regex, LOG_REGEX_NODE_SPLIT, first.start, second.start, -1);
+
+    if (end < 0 || split < 0) {
+        return LOG_REGEX_INVALID;
+    }
+
+    regex->nodes[first.end].out = end;
+    regex->nodes[second.end].out = end;
+    return (LogRegexFragment){ split, end };
+}
+
+// minimum 0 and loop: *, minimum 1 and loop: +, minimum 0 without loop: ?
+static LogRegexFragment Fragment_Repeat(LogRegex* regex, LogRegexFragment fragment, int minimum, int loop) {
+    if (fragment.start < 0) {
+        return LOG_REGEX_INVALID;
+    }
+
+    int32_t end = AddNode(regex, LOG_REGEX_NODE_JUMP, -1, -1, -1);
+    int32_t split = AddNode(regex, LOG_REGEX_NODE_SPLIT, fragment.start, end, -1);
+
+    if (end < 0 || split < 0) {
+        return LOG_REGEX_INVALID;
+    }
+
+    regex->nodes[fragment.end].out = loop ? split : end;
+    return (LogRegexFragment){ minimum == 0 ? split : fragment.start, end };
+}
+
+static void EndRun(LogRegexParser* parser) {
+    if (parser->isTopLevel && parser->runLength > parser->regex->literalLength) {
+        memcpy(parser->regex->literal, parser->run, parser->runLength);
+        parser->regex->literalLength = parser->runLength;
+    }
+
+    parser->runLength = 0;
+}
+
+static void AppendRun(LogRegexParser* parser, int c) {
+    if (parser->isTopLevel && parser->runLength < LOG_REGEX_LITERAL_LIMIT) {
+        parser->run[parser->runLength++] = (char)c;
+    }
+}
+
+static LogRegexFragment ParseClass(LogRegexParser* parser) {
+    LogRegex* regex = parser->regex;
+    int32_t setIndex;
+    uint8_t* set = AddSet(regex, &setIndex);
+
+    if (set == 0) {
+        return LOG_REGEX_INVALID;
+    }
+
+    int negate = parser->cursor < parser->end && *parser->cursor == '^';
+    parser->cursor += negate;
+
+    // A ] right after [ or [^ is a member, not the end.
+    for (int first = 1; ; first = 0) {
+        if (parser->cursor >= parser->end) {
+            return Fail(regex, "missing ]");
+        }
+
+        char low = *parser->cursor++;
+
+        if (low == ']' && !first) {
+            break;
+        }
+
+        if (low == '\\') {
+            if (parser->cursor >= parser->end) {
+                return Fail(regex, "trailing \\");
+            }
+
+            if (SetAddClass(set, *parser->cursor)) {
+                parser->cursor++;
+                continue;
+            }
+
+            low = Unescape(*parser->cursor++);
+        }
+
+        char high = low;
+
+        if (parser->cursor + 1 < parser->end && parser->cursor[0] == '-' && parser->cursor[1] != ']') {
+            parser->cursor++;
+            high = *parser->cursor++;
+
+            if (high == '\\' && parser->cursor < parser->end) {
+                high = Unescape(*parser->cursor++);
+            }
+
+            if ((unsigned char)high < (unsigned char)low) {
+                return Fail(regex, "range out of order in []");
+            }
+        }
+
+        SetAddRange(set, (unsigned char)low, (unsigned char)high);
+    }
+
+    SetFoldCase(set);
+
+    if (negate) {
+        for (size_t i = 0; i < sizeof(regex->sets[setIndex]); i++) {
+            set[i] = (uint8_t)~set[i];
+        }
+    }
+
+    return Fragment_Node(regex, LOG_REGEX_NODE_SET, setIndex);
+}
+
+static LogRegexFragment ParseLiteral(LogRegexParser* parser, char c) {
+    int32_t setIndex;
+    uint8_t* set = AddSet(parser->regex, &setIndex);
+
+    if (set == 0) {
+        return LOG_REGEX_INVALID;
+    }
+
+    SetAdd(set, (unsigned char)c);
+    SetFoldCase(set);
+    parser->atomLiteral = tolower((unsigned char)c);
+
+    return Fragment_Node(parser->regex, LOG_REGEX_NODE_SET, setIndex);
+}
+
+static LogRegexFragment ParseAtom(LogRegexParser* parser) {
+    LogRegex* regex = parser->regex;
+    char c = *parser->cursor++;
+    parser->atomLiteral = -1;
+
+    switch (c) {
+        case '(': {
+            if (parser->end - parser->cursor >= 2 && parser->cursor[0] == '?' && parser->cursor[1] == ':') {
+                parser->cursor += 2;
+            }
+
+            // The group ends the run of literal bytes before it.
+            EndRun(parser);
+            int isTopLevel = parser->isTopLevel;
+            parser->isTopLevel = 0;
+            LogRegexFragment group = ParseAlternation(parser);
+            parser->isTopLevel = isTopLevel;
+            parser->atomLiteral = -1;
+
+            if (parser->cursor >= parser->end || *parser->cursor != ')') {
+                return Fail(regex, "missing )");
+            }
+
+            parser->cursor++;
+            return group;
+        }
+        case '[':
+            return ParseClass(parser);
+        case '.': {
+            int32_t setIndex;
+            uint8_t* set = AddSet(regex, &setIndex);
+
+            if (set == 0) {
+                return LOG_REGEX_INVALID;
+            }
+
+            memset(set, 0xff, sizeof(regex->sets[setIndex]));
+            return Fragment_Node(regex, LOG_REGEX_NODE_SET, setIndex);
+        }
+        case '^':
+            return Fragment_Node(regex, LOG_REGEX_NODE_BEGIN, -1);
+        case '$':
+            return Fragment_Node(regex, LOG_REGEX_NODE_END, -1);
+        case '*':
+        case '+':
+        case '?':
+            return Fail(regex, "nothing to repeat");
+        case '\\': {
+            if (parser->cursor >= parser->end) {
+                return Fail(regex, "trailing \\");
+            }
+
+            char escape = *parser->cursor++;
+
+            if (escape >= '1' && escape <= '9') {
+                return Fail(regex, "backreferences aren't supported");
+            }
+
+            if (escape == 'b' || escape == 'B') {
+                return Fail(regex, "word boundaries aren't supported");
+            }
+
+            if (strchr("dDwWsS", escape) != 0) {
+                int32_t setIndex;
+                uint8_t* set = AddSet(regex, &setIndex);
+
+                if (set == 0) {
+                    return LOG_REGEX_INVALID;
+                }
+
+                SetAddClass(set, escape);
+                return Fragment_Node(regex, LOG_REGEX_NODE_SET, setIndex);
+            }
+
+            if (isalnum((unsigned char)escape) && escape != 'n' && escape != 't' && escape != 'r') {
+                return Fail(regex, "unknown escape");
+            }
+
+            return ParseLiteral(parser, Unescape(escape));
+        }
+        default:
+            return ParseLiteral(parser, c);
+    }
+}
+
+// Reads {m}, {m,} or {m,n} at the cursor. Returns 0 and leaves the cursor alone when it's a literal brace.
+static int ParseBraces(LogRegexParser* parser, int* minimum, int* maximum) {
+    const char* cursor = parser->cursor + 1;
+    int low = 0;
+    int high;
+
+    if (cursor >= parser->end || !isdigit((unsigned char)*cursor)) {
+        return 0;
+    }
+
+    // Counts past LOG_REGEX_MAX_REPEAT stop growing, RepeatCopies turns them down.
+    for (; cursor < parser->end && isdigit((unsigned char)*cursor); cursor++) {
+        low = low > LOG_REGEX_MAX_REPEAT ? low : low * 10 + (*cursor - '0');
+    }
+
+    high = low;
+
+    if (cursor < parser->end && *cursor == ',') {
+        cursor++;
+        high = -1;
+
+        if (cursor < parser->end && isdigit((unsigned char)*cursor)) {
+            high = 0;
+
+            for (; cursor < parser->end && isdigit((unsigned char)*cursor); cursor++) {
+                high = high > LOG_REGEX_MAX_REPEAT ? high : high * 10 + (*cursor - '0');
+            }
+        }
+    }
+
+    if (cursor >= parser->end || *cursor != '}') {
+        return 0;
+    }
+
+    parser->cursor = cursor + 1;
+    *minimum = low;
+    *maximum = high;
+
+    return 1;
+}
+
+static LogRegexFragment ParseConcat(LogRegexParser* parser);
+
+// Another copy of the pattern between from and to, for counted repetitions.
+static LogRegexFragment ParseCopy(LogRegexParser* parser, const char* from, const char* to) {
+    LogRegexParser copy = { .regex = parser->regex, .cursor = from, .end = to };
+    return ParseConcat(&copy);
+}
+
+// x{m,n} becomes m copies of x followed by n - m optional ones, or by x* when there's no n.
+static LogRegexFragment RepeatCopies(LogRegexParser* parser, LogRegexFragment fragment, const char* from, const char* to, int minimum, int maximum) {
+    LogRegex* regex = parser->regex;
+
+    if (maximum >= 0 && (minimum > maximum || maximum > LOG_REGEX_MAX_REPEAT)) {
+        return Fail(regex, "repetition out of range");
+    }
+
+    if (minimum > LOG_REGEX_MAX_REPEAT) {
+        return Fail(regex, "repetition out of range");
+    }
+
+    if (maximum == 0) {
+        return Fragment_Node(regex, LOG_REGEX_NODE_JUMP, -1);
+    }
+
+    if (minimum == 0) {
+        fragment = Fragment_Repeat(regex, fragment, 0, maximum < 0);
+    }
+
+    for (int i = 1; i < minimum && regex->error[0] == '\0'; i++) {
+        fragment = Fragment_Concat(regex, fragment, ParseCopy(parser, from, to));
+    }
+
+    if (maximum < 0 && minimum > 0) {
+        fragment = Fragment_Concat(regex, fragment, Fragment_Repeat(regex, ParseCopy(parser, from, to), 0, 1));
+    }
+
+    for (int i = minimum > 0 ? minimum : 1; i < maximum && regex->error[0] == '\0'; i++) {
+        fragment = Fragment_Concat(regex, fragment, Fragment_Repeat(regex, ParseCopy(parser, from, to), 0, 0));
+    }
+
+    return fragment;
+}
+
+static LogRegexFragment ParseRepeat(LogRegexParser* parser) {
+    LogRegex* regex = parser->regex;
+    const char* atomStart = parser->cursor;
+    LogRegexFragment fragment = ParseAtom(parser);
+    int literal = parser->atomLiteral;
+    int isRepeated = 0;
+    // Fewest times the atom has to match, for the required literal.
+    int minimumCount = 1;
+
+    while (parser->cursor < parser->end && regex->error[0] == '\0') {
+        char c = *parser->cursor;
+        int minimum;
+        int maximum;
+
+        if (c == '*' || c == '+' || c == '?') {
+            parser->cursor++;
+            fragment = Fragment_Repeat(regex, fragment, c == '+', c != '?');
+            minimumCount = c == '+' ? minimumCount : 0;
+        } else if (c == '{') {
+            const char* braceStart = parser->cursor;
+
+            if (!ParseBraces(parser, &minimum, &maximum)) {
+                break;
+            }
+
+            fragment = RepeatCopies(parser, fragment, atomStart, braceStart, minimum, maximum);
+            minimumCount *= minimum;
+        } else {
+            break;
+        }
+
+        isRepeated = 1;
+    }
+
+    if (literal >= 0 && minimumCount > 0) {
+        AppendRun(parser, literal);
+    }
+
+    if (literal < 0 || isRepeated) {
+        EndRun(parser);
+    }
+
+    return fragment;
+}
+
+static LogRegexFragment ParseConcat(LogRegexParser* parser) {
+    LogRegexFragment fragment = Fragment_Node(parser->regex, LOG_REGEX_NODE_JUMP, -1);
+
+    while (parser->cursor < parser->end && *parser->cursor != '|' && *parser->cursor != ')' && parser->regex->error[0] == '\0') {
+        fragment = Fragment_Concat(parser->regex, fragment, ParseRepeat(parser));
+    }
+
+    EndRun(parser);
+
+    return fragment;
+}
+
+static LogRegexFragment ParseAlternation(LogRegexParser* parser) {
+    LogRegexFragment fragment = ParseConcat(parser);
+
+    while (parser->cursor < parser->end && *parser->cursor == '|' && parser->regex->error[0] == '\0') {
+        parser->cursor++;
+
+        // Different branches need different literals, there's no single one left to look for.
+        if (parser->isTopLevel) {
+            parser->isTopLevel = 0;
+            parser->regex->literalLength = 0;
+        }
+
+        fragment = Fragment_Alternate(parser->regex, fragment, ParseConcat(parser));
+    }
+
+    return fragment;
+}
+
+static void Push(LogRegex* regex, uint32_t* top, int32_t node) {
+    if (node >= 0 && regex->marks[node] != regex->markGeneration) {
+        regex->marks[node] = regex->markGeneration;
+        regex->work[(*top)++] = node;
+    }
+}
+
+static void NewGeneration(LogRegex* regex) {
+    if (++regex->markGeneration == 0) {
+        memset(regex->marks, 0, regex->nodeCount * sizeof(uint32_t));
+        regex->markGeneration = 1;
+    }
+}
+
+static int CompareNodes(const void* a, const void* b) {
+    return (*(const int32_t*)a > *(const int32_t*)b) - (*(const int32_t*)a < *(const int32_t*)b);
+}
+
+// Follows every way out of the pushed nodes that doesn't consume a byte. Leaves the sorted nodes that
+// do, the match node and the $ still waiting for the end in regex->closure and returns their count.
+static uint32_t Close(LogRegex* regex, uint32_t top, int atStart, int atEnd) {
+    uint32_t count = 0;
+
+    while (top > 0) {
+        const LogRegexNode* node = &regex->nodes[regex->work[--top]];
+
+        switch (node->type) {
+            case LOG_REGEX_NODE_SPLIT:
+                Push(regex, &top, node->out);
+                Push(regex, &top, node->out1);
+                break;
+            case LOG_REGEX_NODE_JUMP:
+                Push(regex, &top, node->out);
+                break;
+            case LOG_REGEX_NODE_BEGIN:
+                if (atStart) {
+                    Push(regex, &top, node->out);
+                }
+                break;
+            case LOG_REGEX_NODE_END:
+                if (atEnd) {
+                    Push(regex, &top, node->out);
+                } else {
+                    regex->closure[count++] = (int32_t)(node - regex->nodes);
+                }
+                break;
+            default:
+                regex->closure[count++] = (int32_t)(node - regex->nodes);
+                break;
+        }
+    }
+
+    qsort(regex->closure, count, sizeof(int32_t), CompareNodes);
+    return count;
+}
+
+static void Flush(LogRegex* regex) {
+    regex->stateCount = 0;
+    regex->stateNodeCount = 0;
+    regex->startState = -1;
+
+    for (int32_t i = 0; i < LOG_REGEX_BUCKET_COUNT; i++) {
+        regex->buckets[i] = -1;
+    }
+}
+
+// Finds or adds the DFA state for the nodes in regex->closure. Returns LOG_REGEX_FULL when the cache
+// has to be flushed first, -1 when out of memory.
+static int32_t AddState(LogRegex* regex, uint32_t count, int atStart) {
+    uint32_t hash = 2166136261u ^ (uint32_t)atStart;
+
+    for (uint32_t i = 0; i < count; i++) {
+        hash = (hash ^ (uint32_t)regex->closure[i]) * 16777619u;
+    }
+
+    uint32_t bucket = hash & (LOG_REGEX_BUCKET_COUNT - 1);
+
+    for (; regex->buckets[bucket] >= 0; bucket = (bucket + 1) & (LOG_REGEX_BUCKET_COUNT - 1)) {
+        int32_t state = regex->buckets[bucket];
+
+        if (regex->stateHashes[state] == hash && regex->stateLengths[state] == count &&
+            (regex->flags[state] & LOG_REGEX_STATE_AT_START) == (atStart ? LOG_REGEX_STATE_AT_START : 0) &&
+            memcmp(&regex->stateNodes[regex->stateOffsets[state]], regex->closure, count * sizeof(int32_t)) == 0) {
+            return state;
+        }
+    }
+
+    if (regex->stateCount == LOG_REGEX_MAX_STATES) {
+        return LOG_REGEX_FULL;
+    }
+
+    if (regex->stateNodeCount + count > regex->stateNodeCapacity) {
+        uint32_t capacity = (regex->stateNodeCount + count) * 2;
+        int32_t* stateNodes = realloc(regex->stateNodes, capacity * sizeof(int32_t));
+
+        if (stateNodes == 0) {
+            return -1;
+        }
+
+        regex->stateNodes = stateNodes;
+        regex->stateNodeCapacity = capacity;
+    }
+
+    int32_t state = regex->stateCount++;
+    int32_t* nodes = &regex->stateNodes[regex->stateNodeCount];
+    uint8_t flags = atStart ? LOG_REGEX_STATE_AT_START : 0;
+    uint32_t top = 0;
+
+    memcpy(nodes, regex->closure, count * sizeof(int32_t));
+    regex->stateOffsets[state] = regex->stateNodeCount;
+    regex->stateLengths[state] = count;
+    regex->stateHashes[state] = hash;
+    regex->stateNodeCount += count;
+    NewGeneration(regex);
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (regex->nodes[nodes[i]].type == LOG_REGEX_NODE_MATCH) {
+            flags |= LOG_REGEX_STATE_MATCH | LOG_REGEX_STATE_MATCH_AT_END;
+        } else if (regex->nodes[nodes[i]].type == LOG_REGEX_NODE_END) {
+            Push(regex, &top, regex->nodes[nodes[i]].out);
+        }
+    }
+
+    // Whether a $ waiting in this state leads to the match when the text ends here.
+    if (top > 0) {
+        uint32_t endCount = Close(regex, top, atStart, 1);
+
+        for (uint32_t i = 0; i < endCount; i++) {
+            if (regex->nodes[regex->closure[i]].type == LOG_REGEX_NODE_MATCH) {
+                flags |= LOG_REGEX_STATE_MATCH_AT_END;
+            }
+        }
+    }
+
+    regex->flags[state] = count == 0 ? flags | LOG_REGEX_STATE_DEAD : flags;
+
+    for (int c = 0; c < LOG_REGEX_ALPHABET; c++) {
+        regex->transitions[(size_t)state * LOG_REGEX_ALPHABET + c] = -1;
+    }
+
+    regex->buckets[bucket] = state;
+    return state;
+}
+
+static int32_t GetStartState(LogRegex* regex) {
+    if (regex->startState < 0) {
+        uint32_t top = 0;
+        NewGeneration(regex);
+        Push(regex, &top, regex->start);
+        uint32_t count = Close(regex, top, 1, 0);
+        int32_t state = AddState(regex, count, 1);
+
+        if (state == LOG_REGEX_FULL) {
+            Flush(regex);
+            state = AddState(regex, count, 1);
+        }
+
+        regex->startState = state;
+    }
+
+    return regex->startState;
+}
+
+// Builds the state after state reads c. The pattern can start over at every byte, since a match can begin anywhere.
+static int32_t Step(LogRegex* regex, int32_t state, unsigned char c) {
+    const int32_t* nodes = &regex->stateNodes[regex->stateOffsets[state]];
+    uint32_t nodeCount = regex->stateLengths[state];
+    uint32_t top = 0;
+    NewGeneration(regex);
+
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        const LogRegexNode* node = &regex->nodes[nodes[i]];
+
+        if (node->type == LOG_REGEX_NODE_SET && SetHas(regex->sets[node->set], c)) {
+            Push(regex, &top, node->out);
+        }
+    }
+
+    Push(regex, &top, regex->start);
+    uint32_t count = Close(regex, top, 0, 0);
+    int32_t next = AddState(regex, count, 0);
+
+    if (next == LOG_REGEX_FULL) {
+        Flush(regex);
+        return AddState(regex, count, 0);
+    }
+
+    if (next >= 0) {
+        regex->transitions[(size_t)state * LOG_REGEX_ALPHABET + c] = next;
+    }
+
+    return next;
+}
+
+int LogRegex_Compile(LogRegex* regex, const char* pattern) {
+    memset(regex, 0, sizeof(*regex));
+    regex->start = -1;
+    regex->startState = -1;
+    regex->literalAnchor = -1;
+    regex->nodes = malloc(LOG_REGEX_MAX_NODES * sizeof(LogRegexNode));
+    regex->sets = malloc(LOG_REGEX_MAX_NODES * sizeof(regex->sets[0]));
+
+    if (regex->nodes == 0 || regex->sets == 0) {
+        Fail(regex, "out of memory");
+        return 1;
+    }
+
+    LogRegexParser parser = { .regex = regex, .cursor = pattern, .end = pattern + strlen(pattern), .isTopLevel = 1 };
+    LogRegexFragment fragment = ParseAlternation(&parser);
+
+    if (regex->error[0] == '\0' && parser.cursor < parser.end) {
+        Fail(regex, "unmatched )");
+    }
+
+    int32_t match = AddNode(regex, LOG_REGEX_NODE_MATCH, -1, -1, -1);
+
+    if (regex->error[0] != '\0' || fragment.start < 0 || match < 0) {
+        return 1;
+    }
+
+    regex->nodes[fragment.end].out = match;
+    regex->start = fragment.start;
+
+    regex->transitions = malloc((size_t)LOG_REGEX_MAX_STATES * LOG_REGEX_ALPHABET * sizeof(int32_t));
+    regex->flags = malloc(LOG_REGEX_MAX_STATES * sizeof(uint8_t));
+    regex->stateHashes = malloc(LOG_REGEX_MAX_STATES * sizeof(uint32_t));
+    regex->stateOffsets = malloc(LOG_REGEX_MAX_STATES * sizeof(uint32_t));
+    regex->stateLengths = malloc(LOG_REGEX_MAX_STATES * sizeof(uint32_t));
+    regex->buckets = malloc(LOG_REGEX_BUCKET_COUNT * sizeof(int32_t));
+    regex->marks = calloc(regex->nodeCount, sizeof(uint32_t));
+    regex->work = malloc(regex->nodeCount * sizeof(int32_t));
+    regex->closure = malloc(regex->nodeCount * sizeof(int32_t));
+
+    if (regex->transitions == 0 || regex->flags == 0 || regex->stateHashes == 0 || regex->stateOffsets == 0 ||
+        regex->stateLengths == 0 || regex->buckets == 0 || regex->marks == 0 || regex->work == 0 || regex->closure == 0) {
+        Fail(regex, "out of memory");
+        return 1;
+    }
+
+    Flush(regex);
+
+    for (uint32_t i = 0; i < regex->literalLength && regex->literalAnchor < 0; i++) {
+        if (!isalpha((unsigned char)regex->literal[i])) {
+            regex->literalAnchor = (int)i;
+        }
+    }
+
+    return 0;
+}
+
+void LogRegex_Free(LogRegex* regex) {
+    free(regex->nodes);
+    free(regex->sets);
+    free(regex->transitions);
+    free(regex->flags);
+    free(regex->stateHashes);
+    free(regex->stateOffsets);
+    free(regex->stateLengths);
+    free(regex->stateNodes);
+    free(regex->buckets);
+    free(regex->marks);
+    free(regex->work);
+    free(regex->closure);
+    memset(regex, 0, sizeof(*regex));
+}
+
+static int EqualsLiteral(const LogRegex* regex, const char* text) {
+    for (uint32_t i = 0; i < regex->literalLength; i++) {
+        if (tolower((unsigned char)text[i]) != (unsigned char)regex->literal[i]) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+// Looks for the required literal with memchr, on a byte of it that has no other case when there's one.
+static int ContainsLiteral(const LogRegex* regex, const char* text, uint32_t length) {
+    if (length < regex->literalLength) {
+        return 0;
+    }
+
+    // Candidate starts are text .. last.
+    const char* last = text + (length - regex->literalLength);
+
+    if (regex->literalAnchor >= 0) {
+        int anchor = regex->literalAnchor;
+        const char* limit = last + anchor + 1;
+
+        for (const char* found = text + anchor; (found = memchr(found, regex->literal[anchor], limit - found)) != 0; found++) {
+            if (EqualsLiteral(regex, found - anchor)) {
+                return 1;
+            }
+        }
+
+        return 0;
+    }
+
+    int lower = (unsigned char)regex->literal[0];
+    int upper = toupper(lower);
+    const char* lowerFound = memchr(text, lower, last + 1 - text);
+    const char* upperFound = memchr(text, upper, last + 1 - text);
+
+    while (lowerFound != 0 || upperFound != 0) {
+        const char* found = upperFound == 0 || (lowerFound != 0 && lowerFound < upperFound) ? lowerFound : upperFound;
+
+        if (EqualsLiteral(regex, found)) {
+            return 1;
+        }
+
+        if (found == lowerFound) {
+            lowerFound = found < last ? memchr(found + 1, lower, last - found) : 0;
+        } else {
+            upperFound = found < last ? memchr(found + 1, upper, last - found) : 0;
+        }
+    }
+
+    return 0;
+}
+
+int LogRegex_Matches(LogRegex* regex, const char* text, uint32_t length) {
+    if (regex->start < 0 || (regex->literalLength > 0 && !ContainsLiteral(regex, text, length))) {
+        return 0;
+    }
+
+    int32_t state = GetStartState(regex);
+
+    for (uint32_t i = 0; state >= 0; i++) {
+        uint8_t flags = regex->flags[state];
+
+        if (flags & (LOG_REGEX_STATE_MATCH | LOG_REGEX_STATE_DEAD)) {
+            return (flags & LOG_REGEX_STATE_MATCH) != 0;
+        }
+
+        if (i == length) {
+            return (flags & LOG_REGEX_STATE_MATCH_AT_END) != 0;
+        }
+
+        int32_t next = regex->transitions[(size_t)state * LOG_REGEX_ALPHABET + (unsigned char)text[i]];
+        state = next >= 0 ? next : Step(regex, state, (unsigned char)text[i]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+#ifndef IIS_LOG_REGEX_H
+#define IIS_LOG_REGEX_H
+
+#include <stdint.h>
+
+#define LOG_REGEX_MAX_NODES 8192
+// Cached DFA states. When a pattern needs more, the cache starts over, so matching stays linear.
+#define LOG_REGEX_MAX_STATES 1024
+#define LOG_REGEX_ALPHABET 256
+#define LOG_REGEX_LITERAL_LIMIT 64
+#define LOG_REGEX_ERROR_LIMIT 128
+
+typedef enum {
+    LOG_REGEX_NODE_SET,
+    LOG_REGEX_NODE_SPLIT,
+    LOG_REGEX_NODE_JUMP,
+    LOG_REGEX_NODE_BEGIN,
+    LOG_REGEX_NODE_END,
+    LOG_REGEX_NODE_MATCH
+} LogRegexNodeType;
+
+// One state of the Thompson NFA. Sets consume a byte in their bitmap, the rest don't consume anything.
+typedef struct {
+    LogRegexNodeType type;
+    int32_t out;
+    // Second way out of a split.
+    int32_t out1;
+    int32_t set;
+} LogRegexNode;
+
+// Case-insensitive regular expression, matched by a DFA built lazily out of the NFA, one state per set
+// of NFA nodes the text can be in. There's no backtracking, so every byte costs one table lookup once
+// its state is cached, whatever the pattern.
+//
+// Supported: literals, ., [...] and [^...] with ranges, \d \w \s \D \W \S, escaped metacharacters,
+// (...) and (?:...), |, * + ? {m} {m,} {m,n}, and ^ $ anchors. A brace that doesn't start a repetition
+// is a literal, so routes like /api/orders/{id} can be searched as they are.
+typedef struct {
+    LogRegexNode* nodes;
+    int32_t nodeCount;
+    uint8_t (*sets)[LOG_REGEX_ALPHABET / 8];
+    int32_t setCount;
+    int32_t start;
+
+    // The lazily built DFA. Each state is a sorted list of the NFA nodes it stands for.
+    int32_t* transitions;
+    uint8_t* flags;
+    uint32_t* stateHashes;
+    uint32_t* stateOffsets;
+    uint32_t* stateLengths;
+    int32_t* stateNodes;
+    uint32_t stateNodeCount;
+    uint32_t stateNodeCapacity;
+    int32_t* buckets;
+    int32_t stateCount;
+    int32_t startState;
+    // Scratch space for building a state: node marks and the list under construction.
+    uint32_t* marks;
+    uint32_t markGeneration;
+    int32_t* work;
+    int32_t* closure;
+
+    // Longest run of bytes every match has to contain, lowercased. Text without it is skipped
+    // without running the DFA.
+    char literal[LOG_REGEX_LITERAL_LIMIT];
+    uint32_t literalLength;
+    // Position in literal of a byte that isn't a letter, so memchr can look for it as is, or -1.
+    int literalAnchor;
+
+    char error[LOG_REGEX_ERROR_LIMIT];
+} LogRegex;
+
+// Returns 0 on success. On failure regex->error says what's wrong with the pattern and the regex
+// still has to be freed.
+int LogRegex_Compile(LogRegex* regex, const char* pattern);
+void LogRegex_Free(LogRegex* regex);
+
+// Whether the pattern matches anywhere in text. Not const: DFA states are added as the text needs them.
+int LogRegex_Matches(LogRegex* regex, const char* text, uint32_t length);
+
+#endif
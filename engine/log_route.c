@@ -0,0 +1,120 @@
+#include "log_route.h"
+#include <string.h>
+
+#define LOG_ROUTE_HEX_MIN_LENGTH 8
+
+static int IsHexDigit(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static int IsNumber(const char* segment, uint32_t length) {
+    if (length == 0) {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < length; i++) {
+        if (segment[i] < '0' || segment[i] > '9') {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static int IsGuid(const char* segment, uint32_t length) {
+    if (length == 38 && segment[0] == '{' && segment[37] == '}') {
+        segment++;
+        length -= 2;
+    }
+
+    if (length == 32) {
+        for (uint32_t i = 0; i < length; i++) {
+            if (!IsHexDigit(segment[i])) {
+                return 0;
+            }
+        }
+
+        return 1;
+    }
+
+    if (length != 36) {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < length; i++) {
+        int isDashPosition = i == 8 || i == 13 || i == 18 || i == 23;
+
+        if (isDashPosition ? segment[i] != '-' : !IsHexDigit(segment[i])) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+// Words like "cafebabe" are hex too, so a digit is required.
+static int IsHex(const char* segment, uint32_t length) {
+    if (length < LOG_ROUTE_HEX_MIN_LENGTH) {
+        return 0;
+    }
+
+    int hasDigit = 0;
+
+    for (uint32_t i = 0; i < length; i++) {
+        if (!IsHexDigit(segment[i])) {
+            return 0;
+        }
+
+        hasDigit |= segment[i] >= '0' && segment[i] <= '9';
+    }
+
+    return hasDigit;
+}
+
+static uint32_t Append(char* out, uint32_t written, uint32_t outCapacity, const char* text, uint32_t length) {
+    if (written + length > outCapacity) {
+        length = outCapacity - written;
+    }
+
+    memcpy(out + written, text, length);
+
+    return written + length;
+}
+
+uint32_t LogRoute_Templatize(const char* uri, uint32_t length, char* out, uint32_t outCapacity, void* userData) {
+    (void)userData;
+
+    uint32_t written = 0;
+    uint32_t segmentStart = 0;
+
+    for (uint32_t i = 0; i <= length; i++) {
+        if (i < length && uri[i] != '/') {
+            continue;
+        }
+
+        const char* segment = uri + segmentStart;
+        uint32_t segmentLength = i - segmentStart;
+        const char* extension = memchr(segment, '.', segmentLength);
+        uint32_t stemLength = extension ? (uint32_t)(extension - segment) : segmentLength;
+
+        if (IsNumber(segment, stemLength)) {
+            written = Append(out, written, outCapacity, "{id}", 4);
+        } else if (IsGuid(segment, stemLength)) {
+            written = Append(out, written, outCapacity, "{guid}", 6);
+        } else if (IsHex(segment, stemLength)) {
+            written = Append(out, written, outCapacity, "{hex}", 5);
+        } else {
+            stemLength = 0;
+        }
+
+        written = Append(out, written, outCapacity, segment + stemLength, segmentLength - stemLength);
+
+        if (i < length) {
+            written = Append(out, written, outCapacity, "/", 1);
+        }
+
+        segmentStart = i + 1;
+    }
+
+    return written;
+}
@@ -0,0 +1,14 @@
+#ifndef IIS_LOG_ROUTE_H
+#define IIS_LOG_ROUTE_H
+
+#include <stdint.h>
+
+#define LOG_ROUTE_COLUMN "route"
+
+// Rewrites the id-like segments of a cs-uri-stem into placeholders so requests to the same
+// endpoint group together: numbers become {id}, GUIDs {guid} and long hex strings {hex}.
+// A file extension after the segment is kept, /img/123.png becomes /img/{id}.png.
+// Matches LogDeriveFunction, userData is unused.
+uint32_t LogRoute_Templatize(const char* uri, uint32_t length, char* out, uint32_t outCapacity, void* userData);
+
+#endif
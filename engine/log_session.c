@@ -0,0 +1,221 @@
+#include "log_session.h"
+#include "log_thread.h"
+#include "log_trace.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_SESSION_MAX_THREADS 16
+// Below this many rows a single qsort beats starting threads.
+#define LOG_SESSION_PARALLEL_MIN_ROWS 65536
+
+typedef struct {
+    uint64_t key;
+    int64_t timestamp;
+    uint32_t row;
+} SessionEntry;
+
+typedef struct {
+    SessionEntry* source;
+    SessionEntry* destination;
+    uint32_t start;
+    uint32_t middle;
+    uint32_t end;
+} SortJob;
+
+static int CompareEntries(const void* a, const void* b) {
+    const SessionEntry* left = a;
+    const SessionEntry* right = b;
+
+    if (left->key != right->key) {
+        return left->key < right->key ? -1 : 1;
+    }
+
+    if (left->timestamp != right->timestamp) {
+        return left->timestamp < right->timestamp ? -1 : 1;
+    }
+
+    return (left->row > right->row) - (left->row < right->row);
+}
+
+static void RunSortJob(void* userData) {
+    SortJob* job = userData;
+    LOG_TRACE("session sort") qsort(job->source + job->start, job->end - job->start, sizeof(SessionEntry), CompareEntries);
+}
+
+static void RunMergeJob(void* userData) {
+    SortJob* job = userData;
+
+    LOG_TRACE("session merge") {
+        uint32_t left = job->start;
+        uint32_t right = job->middle;
+        uint32_t out = job->start;
+
+        while (left < job->middle && right < job->end) {
+            if (CompareEntries(&job->source[right], &job->source[left]) < 0) {
+                job->destination[out++] = job->source[right++];
+            } else {
+                job->destination[out++] = job->source[left++];
+            }
+        }
+
+        memcpy(job->destination + out, job->source + left, (job->middle - left) * sizeof(SessionEntry));
+        out += job->middle - left;
+        memcpy(job->destination + out, job->source + right, (job->end - right) * sizeof(SessionEntry));
+    }
+}
+
+static void RunJobs(LogThreadFunction function, SortJob* jobs, int jobCount) {
+    LogThread threads[LOG_SESSION_MAX_THREADS];
+    int started[LOG_SESSION_MAX_THREADS] = { 0 };
+
+    for (int i = 1; i < jobCount; i++) {
+        started[i] = LogThread_Start(&threads[i], function, &jobs[i]) == 0;
+
+        if (!started[i]) {
+            function(&jobs[i]);
+        }
+    }
+
+    function(&jobs[0]);
+
+    for (int i = 1; i < jobCount; i++) {
+        if (started[i]) {
+            LogThread_Join(threads[i]);
+        }
+    }
+}
+
+// Sorts chunks on separate threads, then merges neighbouring runs pairwise, also in parallel.
+// Returns the buffer that ends up holding the sorted entries.
+static SessionEntry* ParallelSort(SessionEntry* entries, SessionEntry* scratch, uint32_t count) {
+    int threadCount = LogThread_GetProcessorCount();
+    threadCount = threadCount > LOG_SESSION_MAX_THREADS ? LOG_SESSION_MAX_THREADS : threadCount;
+
+    if (count < LOG_SESSION_PARALLEL_MIN_ROWS || threadCount < 2) {
+        threadCount = 1;
+    }
+
+    uint32_t runStarts[LOG_SESSION_MAX_THREADS + 1];
+    SortJob jobs[LOG_SESSION_MAX_THREADS];
+    int runCount = threadCount;
+
+    for (int i = 0; i <= runCount; i++) {
+        runStarts[i] = (uint32_t)((uint64_t)count * i / runCount);
+    }
+
+    for (int i = 0; i < runCount; i++) {
+        jobs[i] = (SortJob){ .source = entries, .start = runStarts[i], .end = runStarts[i + 1] };
+    }
+
+    RunJobs(RunSortJob, jobs, runCount);
+
+    SessionEntry* source = entries;
+    SessionEntry* destination = scratch;
+
+    while (runCount > 1) {
+        int jobCount = 0;
+        int mergedRunCount = 0;
+
+        for (int i = 0; i < runCount; i += 2) {
+            uint32_t end = i + 2 <= runCount ? runStarts[i + 2] : runStarts[i + 1];
+            uint32_t middle = runStarts[i + 1];
+
+            jobs[jobCount++] = (SortJob){ .source = source, .destination = destination, .start = runStarts[i], .middle = middle, .end = end };
+            runStarts[mergedRunCount++] = runStarts[i];
+        }
+
+        runStarts[mergedRunCount] = count;
+        RunJobs(RunMergeJob, jobs, jobCount);
+
+        runCount = mergedRunCount;
+        SessionEntry* swap = source;
+        source = destination;
+        destination = swap;
+    }
+
+    return source;
+}
+
+static int CompareSessionStarts(const void* a, const void* b) {
+    const LogSession* left = a;
+    const LogSession* right = b;
+
+    if (left->start != right->start) {
+        return left->start < right->start ? -1 : 1;
+    }
+
+    return (left->firstRow > right->firstRow) - (left->firstRow < right->firstRow);
+}
+
+int LogSessions_Build(LogSessions* sessions, const LogTable* table, const uint32_t* rows, uint32_t rowCount, int64_t timeoutSeconds) {
+    memset(sessions, 0, sizeof(*sessions));
+
+    if (table->clientIpColumn < 0) {
+        return 1;
+    }
+
+    if (rows == 0) {
+        rowCount = table->rowCount;
+    }
+
+    SessionEntry* entries = malloc((rowCount > 0 ? rowCount : 1) * sizeof(SessionEntry));
+    SessionEntry* scratch = malloc((rowCount > 0 ? rowCount : 1) * sizeof(SessionEntry));
+    sessions->rows = malloc((rowCount > 0 ? rowCount : 1) * sizeof(uint32_t));
+    sessions->sessions = malloc((rowCount > 0 ? rowCount : 1) * sizeof(LogSession));
+
+    if (entries == 0 || scratch == 0 || sessions->rows == 0 || sessions->sessions == 0) {
+        free(entries);
+        free(scratch);
+        LogSessions_Free(sessions);
+        return 1;
+    }
+
+    for (uint32_t i = 0; i < rowCount; i++) {
+        uint32_t row = rows ? rows[i] : i;
+        uint64_t userAgentId = table->userAgentColumn >= 0 ? LogTable_GetId(table, table->userAgentColumn, row) : 0;
+
+        entries[i].key = (uint64_t)LogTable_GetId(table, table->clientIpColumn, row) << 32 | userAgentId;
+        entries[i].timestamp = LogTable_GetTimestamp(table, row);
+        entries[i].row = row;
+    }
+
+    SessionEntry* sorted = ParallelSort(entries, scratch, rowCount);
+    LogSession* session = 0;
+
+    for (uint32_t i = 0; i < rowCount; i++) {
+        const SessionEntry* entry = &sorted[i];
+        int startsSession = session == 0 || ((uint64_t)session->clientIpId << 32 | session->userAgentId) != entry->key ||
+                            entry->timestamp - session->end > timeoutSeconds;
+
+        if (startsSession) {
+            session = &sessions->sessions[sessions->sessionCount++];
+            session->clientIpId = (uint32_t)(entry->key >> 32);
+            session->userAgentId = (uint32_t)entry->key;
+            session->start = entry->timestamp;
+            session->requestCount = 0;
+            session->totalTimeTaken = 0;
+            session->firstRow = i;
+        }
+
+        int64_t taken = LogTable_GetNumber(table, table->timeTakenColumn, entry->row);
+
+        session->end = entry->timestamp;
+        session->requestCount++;
+        session->totalTimeTaken += taken != LOG_INVALID_NUMBER ? (uint64_t)taken : 0;
+        sessions->rows[i] = entry->row;
+    }
+
+    sessions->rowCount = rowCount;
+    qsort(sessions->sessions, sessions->sessionCount, sizeof(LogSession), CompareSessionStarts);
+
+    free(entries);
+    free(scratch);
+
+    return 0;
+}
+
+void LogSessions_Free(LogSessions* sessions) {
+    free(sessions->sessions);
+    free(sessions->rows);
+    memset(sessions, 0, sizeof(*sessions));
+}
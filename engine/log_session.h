@@ -0,0 +1,32 @@
+#ifndef IIS_LOG_SESSION_H
+#define IIS_LOG_SESSION_H
+
+#include "log_table.h"
+
+#define LOG_SESSION_DEFAULT_TIMEOUT (30 * 60)
+
+// Requests from one client (c-ip plus cs(UserAgent)) with no gap longer than the timeout.
+typedef struct {
+    uint32_t clientIpId;
+    uint32_t userAgentId;
+    int64_t start;
+    int64_t end;
+    uint32_t requestCount;
+    uint64_t totalTimeTaken;
+    // The session's rows are rows[firstRow .. firstRow + requestCount) of LogSessions, in time order.
+    uint32_t firstRow;
+} LogSession;
+
+typedef struct {
+    LogSession* sessions;
+    uint32_t sessionCount;
+    uint32_t* rows;
+    uint32_t rowCount;
+} LogSessions;
+
+// Sorts the given rows (every row when rows is 0) by client and timestamp on all cores and splits
+// them into sessions, ordered by start time. Returns 0 on success.
+int LogSessions_Build(LogSessions* sessions, const LogTable* table, const uint32_t* rows, uint32_t rowCount, int64_t timeoutSeconds);
+void LogSessions_Free(LogSessions* sessions);
+
+#endif
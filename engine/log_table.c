@@ -0,0 +1,646 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include "log_table.h"
+#include "log_route.h"
+#include "log_agent.h"
+#include "log_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_FIELDS_DIRECTIVE "#Fields:"
+#define LOG_DICTIONARY_INITIAL_CAPACITY 64
+
+// Used when a log starts with data lines before any #Fields directive.
+static const char* DEFAULT_FIELDS[] = {
+    "date", "time", "s-ip", "cs-method", "cs-uri-stem", "cs-uri-query", "s-port", "cs-username",
+    "c-ip", "cs(UserAgent)", "cs(Referer)", "sc-status", "sc-substatus", "sc-win32-status", "time-taken"
+};
+
+static const char* NUMBER_FIELDS[] = {
+    "s-port", "sc-status", "sc-substatus", "sc-win32-status", "sc-bytes", "cs-bytes", "time-taken"
+};
+
+static char EMPTY_VALUE[] = "-";
+
+static uint32_t HashValue(const char* value, uint32_t length) {
+    uint32_t hash = 2166136261u;
+
+    for (uint32_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)value[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static int64_t ParseDigits(const char* value, uint32_t length) {
+    if (length == 0 || length > 18) {
+        return LOG_INVALID_NUMBER;
+    }
+
+    int64_t number = 0;
+
+    for (uint32_t i = 0; i < length; i++) {
+        if (value[i] < '0' || value[i] > '9') {
+            return LOG_INVALID_NUMBER;
+        }
+
+        number = number * 10 + (value[i] - '0');
+    }
+
+    return number;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date.
+static int64_t DaysFromCivil(int64_t year, int64_t month, int64_t day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yearOfEra = year - era * 400;
+    int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+
+    return era * 146097 + dayOfEra - 719468;
+}
+
+static void CivilFromDays(int64_t days, int64_t* year, int64_t* month, int64_t* day) {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    int64_t dayOfEra = days - era * 146097;
+    int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int64_t monthIndex = (5 * dayOfYear + 2) / 153;
+
+    *day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    *month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    *year = yearOfEra + era * 400 + (*month <= 2);
+}
+
+static int64_t ParseValue(const char* value, uint32_t length, LogColumnType type) {
+    switch (type) {
+        case LOG_COLUMN_TYPE_NUMBER:
+            return ParseDigits(value, length);
+        case LOG_COLUMN_TYPE_DATE: {
+            // yyyy-mm-dd
+            if (length != 10 || value[4] != '-' || value[7] != '-') {
+                return LOG_INVALID_NUMBER;
+            }
+
+            int64_t year = ParseDigits(value, 4);
+            int64_t month = ParseDigits(value + 5, 2);
+            int64_t day = ParseDigits(value + 8, 2);
+
+            if (year < 0 || month < 1 || month > 12 || day < 1 || day > 31) {
+                return LOG_INVALID_NUMBER;
+            }
+
+            return DaysFromCivil(year, month, day) * 86400;
+        }
+        case LOG_COLUMN_TYPE_TIME: {
+            // hh:mm:ss, optionally followed by fractional seconds which we drop
+            if (length < 8 || value[2] != ':' || value[5] != ':') {
+                return LOG_INVALID_NUMBER;
+            }
+
+            int64_t hours = ParseDigits(value, 2);
+            int64_t minutes = ParseDigits(value + 3, 2);
+            int64_t seconds = ParseDigits(value + 6, 2);
+
+            if (hours < 0 || minutes < 0 || seconds < 0) {
+                return LOG_INVALID_NUMBER;
+            }
+
+            return hours * 3600 + minutes * 60 + seconds;
+        }
+        default:
+            return LOG_INVALID_NUMBER;
+    }
+}
+
+static LogColumnType ColumnTypeFromName(const char* name) {
+    if (strcmp(name, "date") == 0) {
+        return LOG_COLUMN_TYPE_DATE;
+    }
+
+    if (strcmp(name, "time") == 0) {
+        return LOG_COLUMN_TYPE_TIME;
+    }
+
+    for (size_t i = 0; i < sizeof(NUMBER_FIELDS) / sizeof(NUMBER_FIELDS[0]); i++) {
+        if (strcmp(name, NUMBER_FIELDS[i]) == 0) {
+            return LOG_COLUMN_TYPE_NUMBER;
+        }
+    }
+
+    return LOG_COLUMN_TYPE_TEXT;
+}
+
+static void LogDictionary_Rehash(LogDictionary* dictionary, uint32_t bucketCount) {
+    free(dictionary->buckets);
+    dictionary->buckets = calloc(bucketCount, sizeof(uint32_t));
+    dictionary->bucketCount = bucketCount;
+
+    for (uint32_t id = 0; id < dictionary->count; id++) {
+        uint32_t bucket = dictionary->hashes[id] & (bucketCount - 1);
+
+        while (dictionary->buckets[bucket] != 0) {
+            bucket = (bucket + 1) & (bucketCount - 1);
+        }
+
+        dictionary->buckets[bucket] = id + 1;
+    }
+}
+
+static uint32_t LogDictionary_Intern(LogDictionary* dictionary, char* value, uint32_t length, LogColumnType type) {
+    uint32_t hash = HashValue(value, length);
+    uint32_t bucket = hash & (dictionary->bucketCount - 1);
+
+    while (dictionary->buckets[bucket] != 0) {
+        uint32_t id = dictionary->buckets[bucket] - 1;
+
+        if (dictionary->hashes[id] == hash && dictionary->lengths[id] == length && memcmp(dictionary->values[id], value, length) == 0) {
+            return id;
+        }
+
+        bucket = (bucket + 1) & (dictionary->bucketCount - 1);
+    }
+
+    if (dictionary->count == dictionary->capacity) {
+        dictionary->capacity *= 2;
+        dictionary->values = realloc(dictionary->values, dictionary->capacity * sizeof(*dictionary->values));
+        dictionary->lengths = realloc(dictionary->lengths, dictionary->capacity * sizeof(*dictionary->lengths));
+        dictionary->hashes = realloc(dictionary->hashes, dictionary->capacity * sizeof(*dictionary->hashes));
+        dictionary->numbers = realloc(dictionary->numbers, dictionary->capacity * sizeof(*dictionary->numbers));
+    }
+
+    uint32_t id = dictionary->count++;
+    dictionary->values[id] = value;
+    dictionary->lengths[id] = length;
+    dictionary->hashes[id] = hash;
+    dictionary->numbers[id] = ParseValue(value, length, type);
+    dictionary->buckets[bucket] = id + 1;
+
+    if (dictionary->count * 2 > dictionary->bucketCount) {
+        LogDictionary_Rehash(dictionary, dictionary->bucketCount * 2);
+    }
+
+    return id;
+}
+
+static void LogDictionary_Init(LogDictionary* dictionary, LogColumnType type) {
+    dictionary->capacity = LOG_DICTIONARY_INITIAL_CAPACITY;
+    dictionary->values = malloc(dictionary->capacity * sizeof(*dictionary->values));
+    dictionary->lengths = malloc(dictionary->capacity * sizeof(*dictionary->lengths));
+    dictionary->hashes = malloc(dictionary->capacity * sizeof(*dictionary->hashes));
+    dictionary->numbers = malloc(dictionary->capacity * sizeof(*dictionary->numbers));
+    dictionary->bucketCount = LOG_DICTIONARY_INITIAL_CAPACITY * 2;
+    dictionary->buckets = calloc(dictionary->bucketCount, sizeof(uint32_t));
+
+    LogDictionary_Intern(dictionary, EMPTY_VALUE, 1, type);
+}
+
+static void LogDictionary_Free(LogDictionary* dictionary) {
+    if (dictionary->ownsValues) {
+        for (uint32_t id = 0; id < dictionary->count; id++) {
+            if (dictionary->values[id] != EMPTY_VALUE) {
+                free(dictionary->values[id]);
+            }
+        }
+    }
+
+    free(dictionary->values);
+    free(dictionary->lengths);
+    free(dictionary->hashes);
+    free(dictionary->numbers);
+    free(dictionary->buckets);
+    memset(dictionary, 0, sizeof(*dictionary));
+}
+
+int64_t LogDictionary_Find(const LogDictionary* dictionary, const char* value, uint32_t length) {
+    if (dictionary->bucketCount == 0) {
+        return -1;
+    }
+
+    uint32_t hash = HashValue(value, length);
+    uint32_t bucket = hash & (dictionary->bucketCount - 1);
+
+    while (dictionary->buckets[bucket] != 0) {
+        uint32_t id = dictionary->buckets[bucket] - 1;
+
+        if (dictionary->hashes[id] == hash && dictionary->lengths[id] == length && memcmp(dictionary->values[id], value, length) == 0) {
+            return id;
+        }
+
+        bucket = (bucket + 1) & (dictionary->bucketCount - 1);
+    }
+
+    return -1;
+}
+
+int LogTable_FindColumn(const LogTable* table, const char* name) {
+    for (int i = 0; i < table->columnCount; i++) {
+        if (strcmp(table->columns[i].name, name) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static int LogTable_AddColumn(LogTable* table, const char* name, size_t nameLength) {
+    if (nameLength >= LOG_COLUMN_NAME_LIMIT) {
+        nameLength = LOG_COLUMN_NAME_LIMIT - 1;
+    }
+
+    char columnName[LOG_COLUMN_NAME_LIMIT] = { 0 };
+    memcpy(columnName, name, nameLength);
+
+    int existing = LogTable_FindColumn(table, columnName);
+
+    if (existing >= 0) {
+        return existing;
+    }
+
+    if (table->columnCount == LOG_TABLE_MAX_COLUMNS) {
+        return -1;
+    }
+
+    LogColumn* column = &table->columns[table->columnCount];
+    memcpy(column->name, columnName, sizeof(columnName));
+    column->type = ColumnTypeFromName(columnName);
+    LogDictionary_Init(&column->dictionary, column->type);
+    // Rows read before this column showed up in a #Fields directive stay at LOG_EMPTY_VALUE_ID.
+    column->ids = calloc(table->rowCapacity, sizeof(uint32_t));
+    column->sourceColumn = -1;
+
+    return table->columnCount++;
+}
+
+static int ReadWholeFile(const char* path, char** outBuffer, size_t* outSize) {
+    FILE* file = fopen(path, "rb");
+
+    if (file == 0) {
+        return 1;
+    }
+
+#ifdef _WIN32
+    _fseeki64(file, 0, SEEK_END);
+    int64_t size = _ftelli64(file);
+    _fseeki64(file, 0, SEEK_SET);
+#else
+    fseeko(file, 0, SEEK_END);
+    int64_t size = ftello(file);
+    fseeko(file, 0, SEEK_SET);
+#endif
+
+    if (size < 0) {
+        fclose(file);
+        return 1;
+    }
+
+    char* buffer = malloc((size_t)size + 1);
+
+    if (buffer == 0) {
+        fclose(file);
+        return 1;
+    }
+
+    size_t read = 0;
+
+    while (read < (size_t)size) {
+        size_t chunk = fread(buffer + read, 1, (size_t)size - read, file);
+
+        if (chunk == 0) {
+            break;
+        }
+
+        read += chunk;
+    }
+
+    fclose(file);
+    buffer[read] = '\0';
+    *outBuffer = buffer;
+    *outSize = read;
+
+    return 0;
+}
+
+static uint32_t CountLines(const char* buffer, size_t size) {
+    uint32_t lines = 1;
+    const char* end = buffer + size;
+    const char* cursor = buffer;
+
+    while ((cursor = memchr(cursor, '\n', end - cursor)) != 0) {
+        lines++;
+        cursor++;
+    }
+
+    return lines;
+}
+
+static int ParseFieldsDirective(LogTable* table, char* line, char* lineEnd, int* fieldColumns) {
+    int fieldCount = 0;
+    char* cursor = line + strlen(LOG_FIELDS_DIRECTIVE);
+
+    while (cursor < lineEnd && fieldCount < LOG_TABLE_MAX_COLUMNS) {
+        while (cursor < lineEnd && *cursor == ' ') {
+            cursor++;
+        }
+
+        char* nameEnd = cursor;
+
+        while (nameEnd < lineEnd && *nameEnd != ' ') {
+            nameEnd++;
+        }
+
+        if (nameEnd > cursor) {
+            fieldColumns[fieldCount++] = LogTable_AddColumn(table, cursor, nameEnd - cursor);
+        }
+
+        cursor = nameEnd;
+    }
+
+    return fieldCount;
+}
+
+static void ParseRow(LogTable* table, char* line, char* lineEnd, const int* fieldColumns, int fieldCount) {
+    uint32_t row = table->rowCount++;
+    char* cell = line;
+
+    for (int field = 0; field < fieldCount && cell <= lineEnd; field++) {
+        char* cellEnd = memchr(cell, ' ', lineEnd - cell);
+
+        if (cellEnd == 0) {
+            cellEnd = lineEnd;
+        }
+
+        // Tokenize in place so every interned value is also a C string.
+        *cellEnd = '\0';
+
+        if (fieldColumns[field] >= 0) {
+            LogColumn* column = &table->columns[fieldColumns[field]];
+            column->ids[row] = LogDictionary_Intern(&column->dictionary, cell, (uint32_t)(cellEnd - cell), column->type);
+        }
+
+        cell = cellEnd + 1;
+    }
+}
+
+static void LogTable_ParseClientAddresses(LogTable* table) {
+    if (table->clientIpColumn < 0) {
+        return;
+    }
+
+    const LogDictionary* dictionary = &table->columns[table->clientIpColumn].dictionary;
+    table->clientAddresses = calloc(dictionary->count, sizeof(LogAddress));
+
+    if (table->clientAddresses == 0) {
+        return;
+    }
+
+    for (uint32_t id = 0; id < dictionary->count; id++) {
+        LogAddress_Parse(dictionary->values[id], dictionary->lengths[id], &table->clientAddresses[id]);
+    }
+}
+
+int LogTable_AddDerivedColumn(LogTable* table, const char* name, int sourceColumn, LogDeriveFunction derive, void* userData) {
+    if (sourceColumn < 0 || sourceColumn >= table->columnCount || LogTable_FindColumn(table, name) >= 0) {
+        return -1;
+    }
+
+    int index = LogTable_AddColumn(table, name, strlen(name));
+
+    if (index < 0) {
+        return -1;
+    }
+
+    LogColumn* column = &table->columns[index];
+    const LogColumn* source = &table->columns[sourceColumn];
+    uint32_t* derivedIds = malloc(source->dictionary.count * sizeof(uint32_t));
+    char* derived = malloc(LOG_DERIVED_VALUE_LIMIT);
+
+    column->isDerived = 1;
+    column->sourceColumn = sourceColumn;
+    column->dictionary.ownsValues = 1;
+
+    if (derivedIds == 0 || derived == 0) {
+        free(derivedIds);
+        free(derived);
+        return index;
+    }
+
+    for (uint32_t id = 0; id < source->dictionary.count; id++) {
+        uint32_t length = derive(source->dictionary.values[id], source->dictionary.lengths[id], derived, LOG_DERIVED_VALUE_LIMIT, userData);
+        int64_t existing = LogDictionary_Find(&column->dictionary, derived, length);
+
+        if (existing >= 0) {
+            derivedIds[id] = (uint32_t)existing;
+            continue;
+        }
+
+        char* value = malloc(length + 1);
+        memcpy(value, derived, length);
+        value[length] = '\0';
+        derivedIds[id] = LogDictionary_Intern(&column->dictionary, value, length, column->type);
+    }
+
+    for (uint32_t row = 0; row < table->rowCount; row++) {
+        column->ids[row] = derivedIds[source->ids[row]];
+    }
+
+    free(derivedIds);
+    free(derived);
+
+    return index;
+}
+
+int LogTable_BuildAddressTrie(const LogTable* table, const uint32_t* rows, uint32_t rowCount, LogAddressTrie* trie) {
+    memset(trie, 0, sizeof(*trie));
+    trie->root = -1;
+
+    if (table->clientIpColumn < 0 || table->clientAddresses == 0) {
+        return 1;
+    }
+
+    if (rows == 0) {
+        rowCount = table->rowCount;
+    }
+
+    const LogColumn* column = &table->columns[table->clientIpColumn];
+    uint32_t valueCount = column->dictionary.count;
+    uint64_t* rowsPerValue = calloc(valueCount, sizeof(uint64_t));
+
+    if (rowsPerValue == 0 || LogAddressTrie_Init(trie, valueCount) != 0) {
+        free(rowsPerValue);
+        return 1;
+    }
+
+    for (uint32_t i = 0; i < rowCount; i++) {
+        rowsPerValue[column->ids[rows ? rows[i] : i]]++;
+    }
+
+    for (uint32_t id = 0; id < valueCount; id++) {
+        if (rowsPerValue[id] > 0 && table->clientAddresses[id].family != LOG_ADDRESS_FAMILY_NONE) {
+            LogAddressTrie_Insert(trie, &table->clientAddresses[id], id, rowsPerValue[id]);
+        }
+    }
+
+    free(rowsPerValue);
+    return 0;
+}
+
+int LogTable_Load(LogTable* table, const char* path) {
+    memset(table, 0, sizeof(*table));
+    int readResult;
+
+    LOG_TRACE("read file") readResult = ReadWholeFile(path, &table->source, &table->sourceSize);
+
+    if (readResult != 0) {
+        return 1;
+    }
+
+    table->path = malloc(strlen(path) + 1);
+    strcpy(table->path, path);
+    // NOTES: Directive lines are counted as rows here too, so we end up allocating slightly more than we need.
+    table->rowCapacity = CountLines(table->source, table->sourceSize);
+
+    int fieldColumns[LOG_TABLE_MAX_COLUMNS] = { 0 };
+    int fieldCount = 0;
+
+    char* cursor = table->source;
+    char* end = table->source + table->sourceSize;
+
+    LOG_TRACE("parse rows") {
+        while (cursor < end) {
+            char* lineEnd = memchr(cursor, '\n', end - cursor);
+            char* next = lineEnd ? lineEnd + 1 : end;
+
+            if (lineEnd == 0) {
+                lineEnd = end;
+            }
+
+            if (lineEnd > cursor && lineEnd[-1] == '\r') {
+                lineEnd--;
+            }
+
+            if (lineEnd > cursor) {
+                if (*cursor == '#') {
+                    *lineEnd = '\0';
+
+                    if (strncmp(cursor, LOG_FIELDS_DIRECTIVE, strlen(LOG_FIELDS_DIRECTIVE)) == 0) {
+                        fieldCount = ParseFieldsDirective(table, cursor, lineEnd, fieldColumns);
+                    }
+                } else {
+                    if (fieldCount == 0) {
+                        for (size_t i = 0; i < sizeof(DEFAULT_FIELDS) / sizeof(DEFAULT_FIELDS[0]); i++) {
+                            fieldColumns[fieldCount++] = LogTable_AddColumn(table, DEFAULT_FIELDS[i], strlen(DEFAULT_FIELDS[i]));
+                        }
+                    }
+
+                    ParseRow(table, cursor, lineEnd, fieldColumns, fieldCount);
+                }
+            }
+
+            cursor = next;
+        }
+    }
+
+    table->dateColumn = LogTable_FindColumn(table, "date");
+    table->timeColumn = LogTable_FindColumn(table, "time");
+    table->uriStemColumn = LogTable_FindColumn(table, "cs-uri-stem");
+    table->clientIpColumn = LogTable_FindColumn(table, "c-ip");
+    table->userAgentColumn = LogTable_FindColumn(table, "cs(UserAgent)");
+    table->statusColumn = LogTable_FindColumn(table, "sc-status");
+    table->timeTakenColumn = LogTable_FindColumn(table, "time-taken");
+
+    LOG_TRACE("derive columns") {
+        table->routeColumn = LogTable_AddDerivedColumn(table, LOG_ROUTE_COLUMN, table->uriStemColumn, LogRoute_Templatize, 0);
+        table->agentColumn = LogAgent_AddColumn(table);
+    }
+
+    LOG_TRACE("index addresses") {
+        LogTable_ParseClientAddresses(table);
+        LogTable_BuildAddressTrie(table, 0, 0, &table->clientTrie);
+    }
+
+    return 0;
+}
+
+void LogTable_Free(LogTable* table) {
+    for (int i = 0; i < table->columnCount; i++) {
+        LogDictionary_Free(&table->columns[i].dictionary);
+        free(table->columns[i].ids);
+    }
+
+    LogAddressTrie_Free(&table->clientTrie);
+    free(table->clientAddresses);
+    free(table->source);
+    free(table->path);
+    memset(table, 0, sizeof(*table));
+}
+
+void LogTable_FormatTimestamp(int64_t timestamp, char* buffer, int bufferSize) {
+    if (timestamp == LOG_INVALID_NUMBER) {
+        snprintf(buffer, bufferSize, "-");
+        return;
+    }
+
+    int64_t days = timestamp >= 0 ? timestamp / 86400 : (timestamp - 86399) / 86400;
+    int64_t seconds = timestamp - days * 86400;
+    int64_t year, month, day;
+    CivilFromDays(days, &year, &month, &day);
+
+    snprintf(buffer, bufferSize, "%04lld-%02lld-%02lld %02lld:%02lld:%02lld", (long long)year, (long long)month, (long long)day,
+             (long long)(seconds / 3600), (long long)(seconds / 60 % 60), (long long)(seconds % 60));
+}
+
+int64_t LogTable_GetTimestamp(const LogTable* table, uint32_t row) {
+    int64_t date = LogTable_GetNumber(table, table->dateColumn, row);
+    int64_t time = LogTable_GetNumber(table, table->timeColumn, row);
+
+    if (date == LOG_INVALID_NUMBER || time == LOG_INVALID_NUMBER) {
+        return LOG_INVALID_NUMBER;
+    }
+
+    return date + time;
+}
+
+int64_t LogTable_ParseTimestamp(const char* text) {
+    // Typed in rather than read from a log, so nothing may follow it and every field has to be in range.
+    if (strlen(text) != 19 || text[10] != ' ') {
+        return LOG_INVALID_NUMBER;
+    }
+
+    int64_t date = ParseValue(text, 10, LOG_COLUMN_TYPE_DATE);
+    int64_t time = ParseValue(text + 11, 8, LOG_COLUMN_TYPE_TIME);
+
+    if (date == LOG_INVALID_NUMBER || time == LOG_INVALID_NUMBER || ParseDigits(text + 11, 2) > 23 ||
+        ParseDigits(text + 14, 2) > 59 || ParseDigits(text + 17, 2) > 59) {
+        return LOG_INVALID_NUMBER;
+    }
+
+    return date + time;
+}
+
+uint32_t LogTable_FindFirstRowAtTime(const LogTable* table, const uint32_t* rows, uint32_t rowCount, int64_t timestamp) {
+    uint32_t low = 0;
+    uint32_t high = rowCount;
+
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+
+        // Rows without a timestamp count as earlier than any, they can't be jumped to.
+        int64_t rowTimestamp = LogTable_GetTimestamp(table, rows[middle]);
+
+        if (rowTimestamp == LOG_INVALID_NUMBER || rowTimestamp < timestamp) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
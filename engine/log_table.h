@@ -0,0 +1,126 @@
+#ifndef IIS_LOG_TABLE_H
+#define IIS_LOG_TABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "log_address.h"
+
+#define LOG_TABLE_MAX_COLUMNS 32
+#define LOG_COLUMN_NAME_LIMIT 64
+
+// Every dictionary starts with "-", which is what IIS writes for an empty field. Rows that
+// were written under a #Fields directive without a given column point at it as well.
+#define LOG_EMPTY_VALUE_ID 0
+#define LOG_INVALID_NUMBER (-1)
+#define LOG_DERIVED_VALUE_LIMIT 4096
+
+typedef enum {
+    LOG_COLUMN_TYPE_TEXT,
+    LOG_COLUMN_TYPE_NUMBER,
+    LOG_COLUMN_TYPE_DATE,
+    LOG_COLUMN_TYPE_TIME
+} LogColumnType;
+
+// Interned values of a single column. Values are NUL-terminated and point into the source
+// buffer of the table that owns the dictionary, so they're never copied. Derived columns are the
+// exception, their values are computed and owned by the dictionary.
+typedef struct {
+    char** values;
+    uint32_t* lengths;
+    uint32_t* hashes;
+    // Parsed once per distinct value, according to the column type (seconds for dates and times).
+    int64_t* numbers;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t* buckets;
+    uint32_t bucketCount;
+    int ownsValues;
+} LogDictionary;
+
+typedef struct {
+    char name[LOG_COLUMN_NAME_LIMIT];
+    LogColumnType type;
+    LogDictionary dictionary;
+    uint32_t* ids;
+    // Derived columns aren't in the log itself, sourceColumn is the column they're computed from.
+    int isDerived;
+    int sourceColumn;
+} LogColumn;
+
+// Writes the derived value for one source value into out and returns its length.
+typedef uint32_t (*LogDeriveFunction)(const char* value, uint32_t length, char* out, uint32_t outCapacity, void* userData);
+
+typedef struct {
+    char* path;
+    char* source;
+    size_t sourceSize;
+    LogColumn columns[LOG_TABLE_MAX_COLUMNS];
+    int columnCount;
+    uint32_t rowCount;
+    uint32_t rowCapacity;
+    int dateColumn;
+    int timeColumn;
+    int uriStemColumn;
+    int clientIpColumn;
+    int userAgentColumn;
+    int statusColumn;
+    int timeTakenColumn;
+    int routeColumn;
+    int agentColumn;
+    // Parsed once per distinct c-ip value, indexed by its dictionary id.
+    LogAddress* clientAddresses;
+    // Every row's client address, values are c-ip dictionary ids.
+    LogAddressTrie clientTrie;
+} LogTable;
+
+// Loads and parses a W3C extended log. Returns 0 on success, otherwise the table is left empty.
+int LogTable_Load(LogTable* table, const char* path);
+void LogTable_Free(LogTable* table);
+
+int LogTable_FindColumn(const LogTable* table, const char* name);
+
+static inline uint32_t LogTable_GetId(const LogTable* table, int column, uint32_t row) {
+    return table->columns[column].ids[row];
+}
+
+static inline const char* LogTable_GetValue(const LogTable* table, int column, uint32_t row) {
+    const LogColumn* logColumn = &table->columns[column];
+    return logColumn->dictionary.values[logColumn->ids[row]];
+}
+
+static inline uint32_t LogTable_GetLength(const LogTable* table, int column, uint32_t row) {
+    const LogColumn* logColumn = &table->columns[column];
+    return logColumn->dictionary.lengths[logColumn->ids[row]];
+}
+
+static inline int64_t LogTable_GetNumber(const LogTable* table, int column, uint32_t row) {
+    if (column < 0) {
+        return LOG_INVALID_NUMBER;
+    }
+
+    const LogColumn* logColumn = &table->columns[column];
+    return logColumn->dictionary.numbers[logColumn->ids[row]];
+}
+
+// Seconds since the Unix epoch, or LOG_INVALID_NUMBER when the row has no date or time.
+int64_t LogTable_GetTimestamp(const LogTable* table, uint32_t row);
+// Writes "yyyy-mm-dd hh:mm:ss" (UTC, like IIS logs) or "-" for LOG_INVALID_NUMBER.
+void LogTable_FormatTimestamp(int64_t timestamp, char* buffer, int bufferSize);
+// Reads "yyyy-mm-dd hh:mm:ss" back, LOG_INVALID_NUMBER when text isn't exactly one or a field is out of range.
+int64_t LogTable_ParseTimestamp(const char* text);
+// Index into rows of the first one at or after timestamp, rowCount when there's none. Binary
+// searches, so rows have to be in the chronological order IIS writes them in.
+uint32_t LogTable_FindFirstRowAtTime(const LogTable* table, const uint32_t* rows, uint32_t rowCount, int64_t timestamp);
+
+// Adds a column computed from another one. derive runs once per distinct source value and rows
+// are then mapped through the result, so no row is looked at as a string. Returns the column index,
+// or -1 when the source column is missing or there's no room for another column.
+int LogTable_AddDerivedColumn(LogTable* table, const char* name, int sourceColumn, LogDeriveFunction derive, void* userData);
+
+// Builds a trie of client addresses over the given rows, or every row when rows is 0. Returns 0 on success.
+int LogTable_BuildAddressTrie(const LogTable* table, const uint32_t* rows, uint32_t rowCount, LogAddressTrie* trie);
+
+// Returns the id of the value in the dictionary, or -1 when the value never occurs.
+int64_t LogDictionary_Find(const LogDictionary* dictionary, const char* value, uint32_t length);
+
+#endif
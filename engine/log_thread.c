@@ -0,0 +1,78 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "log_thread.h"
+#include "log_trace.h"
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+typedef struct {
+    LogThreadFunction function;
+    void* userData;
+} LogThreadStart;
+
+#ifdef _WIN32
+static DWORD WINAPI LogThread_Entry(LPVOID parameter) {
+#else
+static void* LogThread_Entry(void* parameter) {
+#endif
+    LogThreadStart start = *(LogThreadStart*)parameter;
+    free(parameter);
+    start.function(start.userData);
+    LogTrace_ReleaseThread();
+
+    return 0;
+}
+
+int LogThread_Start(LogThread* thread, LogThreadFunction function, void* userData) {
+    LogThreadStart* start = malloc(sizeof(LogThreadStart));
+
+    if (start == 0) {
+        return 1;
+    }
+
+    start->function = function;
+    start->userData = userData;
+
+#ifdef _WIN32
+    *thread = CreateThread(0, 0, LogThread_Entry, start, 0, 0);
+
+    if (*thread == 0) {
+        free(start);
+        return 1;
+    }
+#else
+    if (pthread_create(thread, 0, LogThread_Entry, start) != 0) {
+        free(start);
+        return 1;
+    }
+#endif
+
+    return 0;
+}
+
+void LogThread_Join(LogThread thread) {
+#ifdef _WIN32
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, 0);
+#endif
+}
+
+int LogThread_GetProcessorCount(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
@@ -0,0 +1,19 @@
+#ifndef IIS_LOG_THREAD_H
+#define IIS_LOG_THREAD_H
+
+#ifdef _WIN32
+// A HANDLE; windows.h is kept out of this header because it clashes with raylib.h.
+typedef void* LogThread;
+#else
+#include <pthread.h>
+typedef pthread_t LogThread;
+#endif
+
+typedef void (*LogThreadFunction)(void* userData);
+
+// Returns 0 on success.
+int LogThread_Start(LogThread* thread, LogThreadFunction function, void* userData);
+void LogThread_Join(LogThread thread);
+int LogThread_GetProcessorCount(void);
+
+#endif
@@ -0,0 +1,114 @@
+#include "log_trace.h"
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#define LOG_TRACE_THREAD_LOCAL __declspec(thread)
+#define CLAIM(flag) (InterlockedCompareExchange((flag), 1, 0) == 0)
+#define RELEASE(flag) InterlockedExchange((flag), 0)
+#define NEXT_THREAD_ID() ((uint32_t)InterlockedIncrement(&lastThreadId))
+#define PUBLISH() MemoryBarrier()
+#else
+#define LOG_TRACE_THREAD_LOCAL __thread
+#define CLAIM(flag) __sync_bool_compare_and_swap((flag), 0, 1)
+#define RELEASE(flag) __sync_lock_release(flag)
+#define NEXT_THREAD_ID() ((uint32_t)__sync_add_and_fetch(&lastThreadId, 1))
+#define PUBLISH() __sync_synchronize()
+#endif
+
+typedef struct {
+    LogTraceEvent* events;
+    // Events ever recorded into this buffer, the last LOG_TRACE_BUFFER_EVENTS of them are still there.
+    volatile uint32_t written;
+    volatile long isClaimed;
+} TraceBuffer;
+
+static TraceBuffer buffers[LOG_TRACE_MAX_THREADS];
+static volatile long lastThreadId = 0;
+static LOG_TRACE_THREAD_LOCAL TraceBuffer* threadBuffer = 0;
+static LOG_TRACE_THREAD_LOCAL uint32_t threadId = 0;
+
+// Claims a free buffer for the calling thread the first time it records. Spans of threads past
+// LOG_TRACE_MAX_THREADS aren't recorded.
+static TraceBuffer* GetThreadBuffer(void) {
+    if (threadBuffer != 0) {
+        return threadBuffer;
+    }
+
+    for (int i = 0; i < LOG_TRACE_MAX_THREADS; i++) {
+        if (CLAIM(&buffers[i].isClaimed)) {
+            if (buffers[i].events == 0) {
+                buffers[i].events = malloc(LOG_TRACE_BUFFER_EVENTS * sizeof(LogTraceEvent));
+            }
+
+            if (buffers[i].events == 0) {
+                RELEASE(&buffers[i].isClaimed);
+                return 0;
+            }
+
+            threadBuffer = &buffers[i];
+            threadId = NEXT_THREAD_ID();
+            return threadBuffer;
+        }
+    }
+
+    return 0;
+}
+
+void LogTrace_Record(const char* name, uint64_t start, uint64_t end) {
+    TraceBuffer* buffer = GetThreadBuffer();
+
+    if (buffer == 0) {
+        return;
+    }
+
+    LogTraceEvent* event = &buffer->events[buffer->written % LOG_TRACE_BUFFER_EVENTS];
+    event->name = name;
+    event->start = start;
+    event->duration = end - start;
+    event->threadId = threadId;
+
+    // The event has to be complete before a reader sees it counted.
+    PUBLISH();
+    buffer->written++;
+}
+
+void LogTrace_End(const char* name, uint64_t start) {
+    LogTrace_Record(name, start, LogProfile_Now());
+}
+
+void LogTrace_ReleaseThread(void) {
+    if (threadBuffer != 0) {
+        RELEASE(&threadBuffer->isClaimed);
+        threadBuffer = 0;
+    }
+}
+
+int LogTrace_Write(FILE* file) {
+    int isFirst = 1;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    for (int i = 0; i < LOG_TRACE_MAX_THREADS; i++) {
+        const TraceBuffer* buffer = &buffers[i];
+        uint32_t written = buffer->written;
+        uint32_t first = written > LOG_TRACE_BUFFER_EVENTS ? written - LOG_TRACE_BUFFER_EVENTS : 0;
+
+        if (buffer->events == 0) {
+            continue;
+        }
+
+        PUBLISH();
+
+        for (uint32_t index = first; index < written; index++) {
+            const LogTraceEvent* event = &buffer->events[index % LOG_TRACE_BUFFER_EVENTS];
+            fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%llu,\"dur\":%llu}", isFirst ? "" : ",", event->name, event->threadId,
+                    (unsigned long long)event->start, (unsigned long long)event->duration);
+            isFirst = 0;
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+
+    return ferror(file) != 0;
+}
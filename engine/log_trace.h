@@ -0,0 +1,35 @@
+#ifndef IIS_LOG_TRACE_H
+#define IIS_LOG_TRACE_H
+
+#include "log_profile.h"
+
+// Threads that can record at the same time. A thread hands its buffer back when it ends, so workers
+// started over and over reuse the same ones, and the events already in a buffer stay in it.
+#define LOG_TRACE_MAX_THREADS 64
+// Events each buffer keeps before the oldest ones get overwritten.
+#define LOG_TRACE_BUFFER_EVENTS 16384
+
+typedef struct {
+    // A string literal, names are written to the trace as they are.
+    const char* name;
+    uint64_t start;
+    uint64_t duration;
+    uint32_t threadId;
+} LogTraceEvent;
+
+// Records the statement or block after it as one span, see LOG_PROFILE.
+#define LOG_TRACE(name) \
+    for (uint64_t logTraceStart = LogProfile_Now(), logTraceOnce = 1; logTraceOnce; logTraceOnce = 0, LogTrace_End((name), logTraceStart))
+
+// Spans are recorded into a buffer owned by the calling thread, so recording never waits on a lock.
+// start and end are LogProfile_Now microseconds.
+void LogTrace_Record(const char* name, uint64_t start, uint64_t end);
+void LogTrace_End(const char* name, uint64_t start);
+// Hands the calling thread's buffer back. LogThread does it for the threads it starts.
+void LogTrace_ReleaseThread(void);
+
+// Writes every buffered span as Chrome trace JSON (chrome://tracing, ui.perfetto.dev). Spans still
+// being recorded by other threads can come out garbled. Returns 0 on success.
+int LogTrace_Write(FILE* file);
+
+#endif
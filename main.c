@@ -1,90 +1,187 @@
 #define CLAY_IMPLEMENTATION
 #include "include/clay.h"
 #include "renderers/raylib/clay_renderer_raylib.c"
+#include "engine/log_table.h"
+#include "engine/log_aggregate.h"
+#include "engine/log_filter.h"
+#include "engine/log_session.h"
+#include "engine/log_export.h"
+#include "engine/log_profile.h"
+#include "engine/log_trace.h"
+#include "table_layout.h"
 #include <stdio.h>
 #include <assert.h>
 #include <ctype.h>
 
-const int FONT_ID_BODY_16 = 0;
-const Clay_Color FOREGROUND_COLOR = {255,255,255,255};
-const Clay_Color BACKGROUND_COLOR = {0,0,140,255};
-const Clay_BorderElementConfig BORDER = { .width = { .left = 5, .right = 5, .top = 5, .bottom = 5  }, .color = FOREGROUND_COLOR };
 int searchBarIsInFocus = 0;
 char searchString[2048] = { 0 };
 int searchStringIndex = 0;
 
-#ifdef _WIN32
-#define LINE_DELIMITER "\r\n"
-#else
-#define LINE_DELIMITER "\n"
-#endif
+typedef enum {
+    VIEW_ROWS,
+    VIEW_CLIENTS,
+    VIEW_ROUTES,
+    VIEW_SESSIONS,
+    VIEW_COMPARISON
+} View;
 
-#define CELL_DELIMITER ' '
-#define CELL_CHAR_LIMIT 10
+View view = VIEW_ROWS;
+
+// Prefix lengths the clients view steps through with the arrow keys, IPv4 and IPv6 side by side.
+const int IPV4_PREFIX_LENGTHS[] = { 8, 16, 24, 32 };
+const int IPV6_PREFIX_LENGTHS[] = { 16, 32, 48, 64 };
+int prefixLevel = 2;
+// Set when a session is clicked, the main loop then narrows the rows down to that client.
+int clickedSession = -1;
+// Set when a cell of the rows view is clicked, the main loop then narrows the rows down to its value.
+int gridWasClicked = 0;
+Clay_Vector2 clickedGridPosition;
+// Ctrl+G in the rows view takes a row number or a time to jump to.
+int jumpBarIsInFocus = 0;
+char jumpString[64] = { 0 };
+int jumpStringIndex = 0;
+// F3 shows how long each stage of the last frames took, F4 writes it to a file next to the log and
+// F5 writes a trace of every stage and worker job.
+int profileOverlayIsVisible = 0;
+
+// Columns of the rows view are fitted between MIN_COLUMN_WIDTH and this, a longer value is cut short with an ellipsis.
+#define MAX_FIT_COLUMN_WIDTH 480
+// Rows measured to fit the columns, and the share of them a column is wide enough for.
+#define COLUMN_FIT_SAMPLE 4096
+#define COLUMN_FIT_PERCENTILE 95
+// Dragging a column edge in the header can't make it narrower than this.
+#define MIN_RESIZED_COLUMN_WIDTH 48
+// How close to a column edge the pointer has to be to drag it.
+#define COLUMN_EDGE_MARGIN 4
+// The same as Clay scrolls its containers by.
+#define WHEEL_SCROLL_PIXELS 10
+#define COMPARISON_COLUMN_COUNT 6
+#define COMPARISON_CELL_LIMIT 64
+#define CLIENT_COLUMN_COUNT 3
+#define CLIENT_CELL_LIMIT LOG_ADDRESS_TEXT_LIMIT
+#define GROUP_COLUMN_COUNT 6
+#define GROUP_CELL_LIMIT 32
+#define SESSION_COLUMN_COUNT 6
+#define SESSION_CELL_LIMIT 32
+#define PROFILE_LINE_LIMIT 128
+#define PATTERN_HITS_LIMIT 256
+// Patterns of an "any" search listed in the search info, the ones with the most hits.
+#define PATTERN_HITS_SHOWN 3
+#define PROFILE_HISTOGRAM_HEIGHT 60
+
+static const Clay_String CLIENT_HEADERS[CLIENT_COLUMN_COUNT] = {
+    CLAY_STRING_CONST("c-ip prefix"), CLAY_STRING_CONST("requests"), CLAY_STRING_CONST("share")
+};
+static const Clay_String ROUTE_HEADERS[GROUP_COLUMN_COUNT] = {
+    CLAY_STRING_CONST("route"), CLAY_STRING_CONST("requests"), CLAY_STRING_CONST("errors %"),
+    CLAY_STRING_CONST("p50 ms"), CLAY_STRING_CONST("p95 ms"), CLAY_STRING_CONST("p99 ms")
+};
+static const Clay_String SESSION_HEADERS[SESSION_COLUMN_COUNT] = {
+    CLAY_STRING_CONST("c-ip"), CLAY_STRING_CONST("cs(UserAgent)"), CLAY_STRING_CONST("start"),
+    CLAY_STRING_CONST("end"), CLAY_STRING_CONST("requests"), CLAY_STRING_CONST("time-taken ms")
+};
+static const Clay_String COMPARISON_HEADERS[COMPARISON_COLUMN_COUNT] = {
+    CLAY_STRING_CONST("cs-uri-stem"), CLAY_STRING_CONST("requests"), CLAY_STRING_CONST("errors %"),
+    CLAY_STRING_CONST("p50 ms"), CLAY_STRING_CONST("p95 ms"), CLAY_STRING_CONST("p99 ms")
+};
+
+typedef struct {
+    LogAddressPrefix* prefixes;
+    uint32_t prefixCount;
+    char* text;
+    Clay_String* cells;
+} ClientTable;
+
+typedef struct {
+    LogSessions sessions;
+    char* text;
+    Clay_String* cells;
+} SessionTable;
+
+typedef struct {
+    LogAggregate aggregate;
+    const LogGroup** groups;
+    uint32_t groupCount;
+    char* text;
+    Clay_String* cells;
+} GroupTable;
 
 void HandleClayErrors(Clay_ErrorData errorData) {
     printf("%s", errorData.errorText.chars);
 }
 
-void RenderTextComponent(Clay_String text) {
-    CLAY_AUTO_ID({
-                     .layout = {
-                         .padding = CLAY_PADDING_ALL(16),
-                         .sizing = { .width = CLAY_SIZING_GROW(100), .height = CLAY_SIZING_GROW(0) },
-                         .childAlignment = { .x = CLAY_ALIGN_X_LEFT, .y = CLAY_ALIGN_Y_CENTER },
-                     },
-                 }) {
-        CLAY_TEXT(text, CLAY_TEXT_CONFIG({
-                                             .fontId = FONT_ID_BODY_16,
-                                             .fontSize = 16,
-                                             .textColor = FOREGROUND_COLOR
-                                         }));
-    }
+// The rows view is one table grid element drawn straight from the column store, instead of a
+// Clay element per cell, so laying it out costs the same whatever the number of rows.
+typedef struct {
+    const LogTable* table;
+    const uint32_t* rows;
+    float columnWidths[LOG_TABLE_MAX_COLUMNS];
+} RowsGrid;
+
+Clay_String RowsGrid_GetCell(void* userData, uint64_t row, int column) {
+    const RowsGrid* grid = userData;
+    const LogDictionary* dictionary = &grid->table->columns[column].dictionary;
+    uint32_t id = LogTable_GetId(grid->table, column, grid->rows[row]);
+
+    return (Clay_String) { .chars = dictionary->values[id], .length = (int32_t)dictionary->lengths[id] };
 }
 
-char* ReadFileContent(FILE* file) {
-    if (file == 0) {
-        puts("Unable to open file with the provided path.");
-        exit(1);
-    }
-    
-    fseek(file, 0, SEEK_END);
-    size_t size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-    
-    char *fileBuffer = calloc(size, sizeof(char));
-    
-    if (fileBuffer == 0) {
-        puts("Unable to allocate memory for file.");
-        exit(1);
-    }
-    
-    fread(fileBuffer, sizeof(*fileBuffer), size, file);
-    
-    if (fileBuffer == 0) {
-        puts("Unable to read content from file.");
-        exit(1);
+float MeasureCell(Font* fonts, const char* chars, uint32_t length) {
+    Clay_TextElementConfig config = { .fontId = FONT_ID_BODY_16, .fontSize = FONT_SIZE };
+    Clay_StringSlice text = { .chars = chars, .length = (int32_t)length };
+
+    return Raylib_MeasureText(text, &config, fonts).width;
+}
+
+int CompareWidths(const void* a, const void* b) {
+    float left = *(const float*)a;
+    float right = *(const float*)b;
+
+    return (left > right) - (left < right);
+}
+
+// Fits each column to its name and to most of its values, measured over rows spread through the whole
+// log so the widths follow how often each value shows up. The few longer ones get cut short when drawn.
+void RowsGrid_FitColumns(RowsGrid* grid, Font* fonts) {
+    const LogTable* table = grid->table;
+    uint32_t sampleCount = table->rowCount < COLUMN_FIT_SAMPLE ? table->rowCount : COLUMN_FIT_SAMPLE;
+    float widths[COLUMN_FIT_SAMPLE];
+
+    for (int column = 0; column < table->columnCount; column++) {
+        const LogColumn* logColumn = &table->columns[column];
+        float width = MeasureCell(fonts, logColumn->name, (uint32_t)strlen(logColumn->name));
+
+        for (uint32_t i = 0; i < sampleCount; i++) {
+            uint32_t row = (uint32_t)((uint64_t)i * table->rowCount / sampleCount);
+            uint32_t id = LogTable_GetId(table, column, row);
+            widths[i] = MeasureCell(fonts, logColumn->dictionary.values[id], logColumn->dictionary.lengths[id]);
+        }
+
+        if (sampleCount > 0) {
+            qsort(widths, sampleCount, sizeof(float), CompareWidths);
+            float valueWidth = widths[(sampleCount - 1) * COLUMN_FIT_PERCENTILE / 100];
+            width = valueWidth > width ? valueWidth : width;
+        }
+
+        width += 2 * CELL_PADDING;
+        width = width < MAX_FIT_COLUMN_WIDTH ? width : MAX_FIT_COLUMN_WIDTH;
+        grid->columnWidths[column] = width > MIN_COLUMN_WIDTH ? width : MIN_COLUMN_WIDTH;
     }
-    
-    return fileBuffer;
 }
 
-// NOTES: For now, this considers every four metadata lines of an IIS log file, so we
-// end up allocating more memory than we actually need. Its ok for this to stay for now, it'll hardly be
-// that much more memory anyway.
-size_t CountCellsInFile(char* string) {
-    size_t count = 0;
-    
-    while (*string != '\0') {
-        int isACellInTheMiddleOrEndOfTheLine = *string == CELL_DELIMITER || *string == '\n';
-        if (isACellInTheMiddleOrEndOfTheLine) {
-            count++;
+// The column whose right edge in the header is under x, or -1. left is where the first column starts.
+int RowsGrid_FindColumnEdge(const RowsGrid* grid, float left, float x) {
+    float edge = left;
+
+    for (int column = 0; column < grid->table->columnCount; column++) {
+        edge += grid->columnWidths[column];
+
+        if (x >= edge - COLUMN_EDGE_MARGIN && x <= edge + COLUMN_EDGE_MARGIN) {
+            return column;
         }
-        
-        string++;
     }
-    
-    return count;
+
+    return -1;
 }
 
 void HandleFocusInteraction(Clay_ElementId clayElementId, Clay_PointerData pointerData, intptr_t userData) {
@@ -93,6 +190,136 @@ void HandleFocusInteraction(Clay_ElementId clayElementId, Clay_PointerData point
     }
 }
 
+void HandleSessionClick(Clay_ElementId clayElementId, Clay_PointerData pointerData, intptr_t userData) {
+    if (pointerData.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
+        clickedSession = (int)userData;
+    }
+}
+
+void HandleGridClick(Clay_ElementId clayElementId, Clay_PointerData pointerData, intptr_t userData) {
+    if (pointerData.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
+        gridWasClicked = 1;
+        clickedGridPosition = pointerData.position;
+    }
+}
+
+// Whole pixel scroll offsets let the renderer shift its cached table lines instead of drawing them again.
+Clay_Vector2 GetPixelAlignedScrollOffset(Clay_ScrollContainerData scrollData) {
+    if (!scrollData.found) {
+        return (Clay_Vector2){ 0, 0 };
+    }
+
+    return (Clay_Vector2){ roundf(scrollData.scrollPosition->x), roundf(scrollData.scrollPosition->y) };
+}
+
+// Returns 0 on success.
+int WriteReport(const char* path, int (*write)(FILE* file)) {
+    FILE* file = fopen(path, "w");
+    int result = file == 0 || write(file) != 0;
+
+    if (file != 0 && fclose(file) != 0) {
+        result = 1;
+    }
+
+    return result;
+}
+
+void RenderProfileLine(const char* text) {
+    CLAY_TEXT(((Clay_String){ .chars = text, .length = (int32_t)strlen(text) }), CLAY_TEXT_CONFIG({
+                                                                                        .fontId = FONT_ID_BODY_16,
+                                                                                        .fontSize = FONT_SIZE,
+                                                                                        .textColor = FOREGROUND_COLOR
+                                                                                    }));
+}
+
+// Floats over the top right corner with a line per stage and a histogram of the frame times. The
+// text has to outlive the layout until it's drawn, so it's kept in static buffers.
+void RenderProfileOverlay(const char* status) {
+    static char lines[LOG_PROFILE_STAGE_COUNT + 1][PROFILE_LINE_LIMIT];
+
+    CLAY(CLAY_ID("ProfileOverlay"), {
+             .layout = {
+                 .layoutDirection = CLAY_TOP_TO_BOTTOM,
+                 .padding = CLAY_PADDING_ALL(CELL_PADDING),
+                 .childGap = 4
+             },
+             .backgroundColor = BACKGROUND_COLOR,
+             .border = BORDER,
+             .cornerRadius = CLAY_CORNER_RADIUS(10),
+             .floating = {
+                 .attachTo = CLAY_ATTACH_TO_ROOT,
+                 .attachPoints = { .element = CLAY_ATTACH_POINT_RIGHT_TOP, .parent = CLAY_ATTACH_POINT_RIGHT_TOP },
+                 .offset = { -10, 70 },
+                 .zIndex = 1,
+                 .pointerCaptureMode = CLAY_POINTER_CAPTURE_MODE_PASSTHROUGH
+             }
+         }) {
+        for (int stage = 0; stage < LOG_PROFILE_STAGE_COUNT; stage++) {
+            LogProfileSummary summary = LogProfile_Summarize((LogProfileStage)stage);
+            snprintf(lines[stage], PROFILE_LINE_LIMIT, "%-8s last %8.2f  p50 %8.2f  p95 %8.2f  max %8.2f ms", LogProfile_StageName((LogProfileStage)stage),
+                     summary.last / 1000.0, summary.p50 / 1000.0, summary.p95 / 1000.0, summary.max / 1000.0);
+            RenderProfileLine(lines[stage]);
+        }
+
+        snprintf(lines[LOG_PROFILE_STAGE_COUNT], PROFILE_LINE_LIMIT, "%llu render commands, %llu elements, %llu rows scanned",
+                 (unsigned long long)LogProfile_GetCounter(LOG_PROFILE_COUNTER_RENDER_COMMANDS),
+                 (unsigned long long)LogProfile_GetCounter(LOG_PROFILE_COUNTER_ELEMENTS),
+                 (unsigned long long)LogProfile_GetCounter(LOG_PROFILE_COUNTER_ROWS_SCANNED));
+        RenderProfileLine(lines[LOG_PROFILE_STAGE_COUNT]);
+
+        // Frame times in doubling buckets from 1 us up, over the same window as the numbers above.
+        const LogProfileTimer* frameTimer = LogProfile_GetTimer(LOG_PROFILE_STAGE_FRAME);
+        uint32_t tallestBucket = 1;
+
+        for (int bucket = 0; bucket < LOG_PROFILE_BUCKET_COUNT; bucket++) {
+            tallestBucket = frameTimer->histogram[bucket] > tallestBucket ? frameTimer->histogram[bucket] : tallestBucket;
+        }
+
+        CLAY(CLAY_ID("ProfileHistogram"), {
+                 .layout = {
+                     .sizing = { .height = CLAY_SIZING_FIXED(PROFILE_HISTOGRAM_HEIGHT) },
+                     .childAlignment = { .y = CLAY_ALIGN_Y_BOTTOM },
+                     .childGap = 2
+                 }
+             }) {
+            for (int bucket = 0; bucket < LOG_PROFILE_BUCKET_COUNT; bucket++) {
+                float height = (float)PROFILE_HISTOGRAM_HEIGHT * frameTimer->histogram[bucket] / tallestBucket;
+
+                CLAY_AUTO_ID({
+                                 .layout = { .sizing = { .width = CLAY_SIZING_FIXED(12), .height = CLAY_SIZING_FIXED(height > 1 ? height : 1) } },
+                                 .backgroundColor = FOREGROUND_COLOR
+                             }) {}
+            }
+        }
+
+        RenderProfileLine(status[0] != 0 ? status : "F3 hides this, F4 writes it to a file, F5 writes a trace");
+    }
+}
+
+// Whether the events polled at the end of the last frame could change what the next one shows.
+int HasPendingInput(void) {
+    Vector2 mouseDelta = GetMouseDelta();
+    Vector2 wheelMove = GetMouseWheelMoveV();
+
+    if (mouseDelta.x != 0 || mouseDelta.y != 0 || wheelMove.x != 0 || wheelMove.y != 0) {
+        return 1;
+    }
+
+    for (int button = MOUSE_BUTTON_LEFT; button <= MOUSE_BUTTON_BACK; button++) {
+        if (IsMouseButtonPressed(button) || IsMouseButtonReleased(button)) {
+            return 1;
+        }
+    }
+
+    for (int key = KEY_SPACE; key <= KEY_KB_MENU; key++) {
+        if (IsKeyPressed(key) || IsKeyPressedRepeat(key) || IsKeyReleased(key)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 int ConvertShiftKey(int key) {
     if (key == KEY_EQUAL)
         return 43;
@@ -118,44 +345,330 @@ int ConvertShiftKey(int key) {
     return 0;
 }
 
-char* strstr_insensitive(char* haystack, char* needle) {
-    assert(haystack != 0);
-    assert(needle != 0);
+// Adds a typed key to a text field, shifted keys are converted to the character they type.
+void TypeKey(char* text, int* textLength, int textLimit, int keyPressed) {
+    if (keyPressed == KEY_BACKSPACE) {
+        if (*textLength > 0) {
+            text[--*textLength] = 0;
+        }
 
-    char* foundPtr = 0;
+        return;
+    }
 
-    char* haystackPtr = haystack;
-    char* needlePtr = needle;
+    if (IsKeyDown(KEY_RIGHT_SHIFT) || IsKeyDown(KEY_LEFT_SHIFT)) {
+        keyPressed = ConvertShiftKey(keyPressed);
+    }
 
-    while (*haystackPtr != '\0') {
-        if (tolower(*haystackPtr) == tolower(*needlePtr)) {
-            if (foundPtr == 0) {
-                foundPtr = haystackPtr;
-            }
+    if (keyPressed != 0 && *textLength < textLimit - 1) {
+        text[(*textLength)++] = (char)keyPressed;
+    }
+}
 
-            needlePtr++;
+void FormatComparisonValue(char* buffer, const LogGroup* before, double beforeValue, const LogGroup* after, double afterValue, int decimals) {
+    if (before != 0 && after != 0) {
+        snprintf(buffer, COMPARISON_CELL_LIMIT, "%.*f -> %.*f (%+.*f)", decimals, beforeValue, decimals, afterValue, decimals, afterValue - beforeValue);
+    } else if (before != 0) {
+        snprintf(buffer, COMPARISON_CELL_LIMIT, "%.*f -> -", decimals, beforeValue);
+    } else {
+        snprintf(buffer, COMPARISON_CELL_LIMIT, "- -> %.*f", decimals, afterValue);
+    }
+}
 
-            if (*needlePtr == '\0') {
-                break;
-            }
-        } else if (foundPtr != 0) {
-            foundPtr = 0;
-            needlePtr = needle;
+// The comparison doesn't change while the viewer is open, so its cells are formatted once up front.
+Clay_String* FormatComparisonCells(const LogComparison* comparison, char** outText) {
+    Clay_String* cells = calloc((size_t)comparison->rowCount * COMPARISON_COLUMN_COUNT + 1, sizeof(Clay_String));
+    char* text = calloc((size_t)comparison->rowCount * COMPARISON_COLUMN_COUNT + 1, COMPARISON_CELL_LIMIT);
+
+    if (cells == 0 || text == 0) {
+        puts("Unable to allocate memory for the comparison.");
+        exit(1);
+    }
+
+    for (uint32_t i = 0; i < comparison->rowCount; i++) {
+        const LogComparisonRow* row = &comparison->rows[i];
+        const LogGroup* before = row->before;
+        const LogGroup* after = row->after;
+        Clay_String* rowCells = cells + (size_t)i * COMPARISON_COLUMN_COUNT;
+        char* rowText = text + (size_t)i * COMPARISON_COLUMN_COUNT * COMPARISON_CELL_LIMIT;
+
+        rowCells[0] = (Clay_String){ .chars = row->key, .length = (int32_t)row->keyLength };
+        FormatComparisonValue(rowText + 1 * COMPARISON_CELL_LIMIT, before, before ? before->count : 0, after, after ? after->count : 0, 0);
+        FormatComparisonValue(rowText + 2 * COMPARISON_CELL_LIMIT, before, LogGroup_ErrorRate(before) * 100.0, after, LogGroup_ErrorRate(after) * 100.0, 1);
+        FormatComparisonValue(rowText + 3 * COMPARISON_CELL_LIMIT, before, before ? before->p50 : 0, after, after ? after->p50 : 0, 0);
+        FormatComparisonValue(rowText + 4 * COMPARISON_CELL_LIMIT, before, before ? before->p95 : 0, after, after ? after->p95 : 0, 0);
+        FormatComparisonValue(rowText + 5 * COMPARISON_CELL_LIMIT, before, before ? before->p99 : 0, after, after ? after->p99 : 0, 0);
+
+        for (int column = 1; column < COMPARISON_COLUMN_COUNT; column++) {
+            char* cellText = rowText + column * COMPARISON_CELL_LIMIT;
+            rowCells[column] = (Clay_String){ .chars = cellText, .length = (int32_t)strlen(cellText) };
+        }
+    }
+
+    *outText = text;
+    return cells;
+}
+
+// Hits per pattern of a pattern list search, the most hit first, like ", hits: /.env 12, /wp-login 3".
+// Empty for other searches.
+void FormatPatternHits(const LogFilter* filter, const LogTable* table, const uint32_t* rows, uint32_t rowCount, char* buffer) {
+    buffer[0] = '\0';
+
+    if (filter->patternCount == 0) {
+        return;
+    }
+
+    uint32_t* hits = calloc(filter->patternCount, sizeof(uint32_t));
+
+    if (hits == 0) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < rowCount; i++) {
+        int pattern = LogFilter_GetPattern(filter, table, rows[i]);
+
+        if (pattern >= 0) {
+            hits[pattern]++;
         }
+    }
+
+    size_t length = snprintf(buffer, PATTERN_HITS_LIMIT, ", hits:");
+
+    for (int shown = 0; shown < PATTERN_HITS_SHOWN; shown++) {
+        int top = 0;
+
+        for (int pattern = 1; pattern < filter->patternCount; pattern++) {
+            top = hits[pattern] > hits[top] ? pattern : top;
+        }
+
+        if (hits[top] == 0 || length >= PATTERN_HITS_LIMIT) {
+            break;
+        }
+
+        length += snprintf(buffer + length, PATTERN_HITS_LIMIT - length, "%s %s %u", shown > 0 ? "," : "", filter->patterns[top], hits[top]);
+        hits[top] = 0;
+    }
+
+    free(hits);
+}
+
+void ClientTable_Free(ClientTable* clients) {
+    free(clients->prefixes);
+    free(clients->text);
+    free(clients->cells);
+    memset(clients, 0, sizeof(*clients));
+}
+
+// Groups the filtered rows by client address prefix through a radix trie of their c-ip values.
+void ClientTable_Build(ClientTable* clients, const LogTable* table, const uint32_t* rows, uint32_t rowCount) {
+    ClientTable_Free(clients);
+
+    LogAddressTrie trie;
+    LogTable_BuildAddressTrie(table, rows, rowCount, &trie);
+    clients->prefixes = LogAddressTrie_GroupByPrefix(&trie, IPV4_PREFIX_LENGTHS[prefixLevel], IPV6_PREFIX_LENGTHS[prefixLevel], &clients->prefixCount);
+    LogAddressTrie_Free(&trie);
+
+    clients->cells = calloc((size_t)clients->prefixCount * CLIENT_COLUMN_COUNT + 1, sizeof(Clay_String));
+    clients->text = calloc((size_t)clients->prefixCount * CLIENT_COLUMN_COUNT + 1, CLIENT_CELL_LIMIT);
+
+    if (clients->cells == 0 || clients->text == 0) {
+        puts("Unable to allocate memory for the client prefixes.");
+        exit(1);
+    }
+
+    for (uint32_t i = 0; i < clients->prefixCount; i++) {
+        const LogAddressPrefix* prefix = &clients->prefixes[i];
+        char* prefixText = clients->text + (size_t)i * CLIENT_COLUMN_COUNT * CLIENT_CELL_LIMIT;
+
+        LogAddress_FormatPrefix(&prefix->prefix, prefix->prefixLength, prefixText, CLIENT_CELL_LIMIT);
+        snprintf(prefixText + CLIENT_CELL_LIMIT, CLIENT_CELL_LIMIT, "%llu", (unsigned long long)prefix->count);
+        snprintf(prefixText + 2 * CLIENT_CELL_LIMIT, CLIENT_CELL_LIMIT, "%.2f%%", rowCount > 0 ? prefix->count * 100.0 / rowCount : 0.0);
+
+        for (int column = 0; column < CLIENT_COLUMN_COUNT; column++) {
+            char* cellText = prefixText + column * CLIENT_CELL_LIMIT;
+            clients->cells[(size_t)i * CLIENT_COLUMN_COUNT + column] = (Clay_String){ .chars = cellText, .length = (int32_t)strlen(cellText) };
+        }
+    }
+}
+
+void GroupTable_Free(GroupTable* groupTable) {
+    LogAggregate_Free(&groupTable->aggregate);
+    free(groupTable->groups);
+    free(groupTable->text);
+    free(groupTable->cells);
+    memset(groupTable, 0, sizeof(*groupTable));
+}
+
+int CompareGroupCounts(const void* a, const void* b) {
+    uint32_t left = (*(const LogGroup**)a)->count;
+    uint32_t right = (*(const LogGroup**)b)->count;
+
+    return (left < right) - (left > right);
+}
+
+// Aggregates the filtered rows by a column, busiest values first.
+void GroupTable_Build(GroupTable* groupTable, const LogTable* table, int keyColumn, const uint32_t* rows, uint32_t rowCount) {
+    GroupTable_Free(groupTable);
+
+    if (LogAggregate_Build(&groupTable->aggregate, table, keyColumn, rows, rowCount) != 0) {
+        return;
+    }
+
+    groupTable->groups = malloc((groupTable->aggregate.groupCount + 1) * sizeof(LogGroup*));
+
+    for (uint32_t id = 0; id < groupTable->aggregate.groupCount; id++) {
+        if (groupTable->aggregate.groups[id].count > 0) {
+            groupTable->groups[groupTable->groupCount++] = &groupTable->aggregate.groups[id];
+        }
+    }
+
+    qsort(groupTable->groups, groupTable->groupCount, sizeof(LogGroup*), CompareGroupCounts);
+
+    groupTable->cells = calloc((size_t)groupTable->groupCount * GROUP_COLUMN_COUNT + 1, sizeof(Clay_String));
+    groupTable->text = calloc((size_t)groupTable->groupCount * (GROUP_COLUMN_COUNT - 1) + 1, GROUP_CELL_LIMIT);
+
+    if (groupTable->groups == 0 || groupTable->cells == 0 || groupTable->text == 0) {
+        puts("Unable to allocate memory for the grouped rows.");
+        exit(1);
+    }
+
+    const LogDictionary* keys = &table->columns[keyColumn].dictionary;
+
+    for (uint32_t i = 0; i < groupTable->groupCount; i++) {
+        const LogGroup* group = groupTable->groups[i];
+        Clay_String* rowCells = groupTable->cells + (size_t)i * GROUP_COLUMN_COUNT;
+        char* rowText = groupTable->text + (size_t)i * (GROUP_COLUMN_COUNT - 1) * GROUP_CELL_LIMIT;
+
+        rowCells[0] = (Clay_String){ .chars = keys->values[group->keyId], .length = (int32_t)keys->lengths[group->keyId] };
+        snprintf(rowText, GROUP_CELL_LIMIT, "%u", group->count);
+        snprintf(rowText + GROUP_CELL_LIMIT, GROUP_CELL_LIMIT, "%.1f", LogGroup_ErrorRate(group) * 100.0);
+        snprintf(rowText + 2 * GROUP_CELL_LIMIT, GROUP_CELL_LIMIT, "%u", group->p50);
+        snprintf(rowText + 3 * GROUP_CELL_LIMIT, GROUP_CELL_LIMIT, "%u", group->p95);
+        snprintf(rowText + 4 * GROUP_CELL_LIMIT, GROUP_CELL_LIMIT, "%u", group->p99);
+
+        for (int column = 1; column < GROUP_COLUMN_COUNT; column++) {
+            char* cellText = rowText + (column - 1) * GROUP_CELL_LIMIT;
+            rowCells[column] = (Clay_String){ .chars = cellText, .length = (int32_t)strlen(cellText) };
+        }
+    }
+}
+
+void SessionTable_Free(SessionTable* sessionTable) {
+    LogSessions_Free(&sessionTable->sessions);
+    free(sessionTable->text);
+    free(sessionTable->cells);
+    memset(sessionTable, 0, sizeof(*sessionTable));
+}
+
+void SessionTable_Build(SessionTable* sessionTable, const LogTable* table, const uint32_t* rows, uint32_t rowCount) {
+    SessionTable_Free(sessionTable);
 
-        haystackPtr++;
+    if (LogSessions_Build(&sessionTable->sessions, table, rows, rowCount, LOG_SESSION_DEFAULT_TIMEOUT) != 0) {
+        return;
     }
 
-    if (*needlePtr != '\0') {
-        return 0;
+    uint32_t sessionCount = sessionTable->sessions.sessionCount;
+    sessionTable->cells = calloc((size_t)sessionCount * SESSION_COLUMN_COUNT + 1, sizeof(Clay_String));
+    sessionTable->text = calloc((size_t)sessionCount * (SESSION_COLUMN_COUNT - 2) + 1, SESSION_CELL_LIMIT);
+
+    if (sessionTable->cells == 0 || sessionTable->text == 0) {
+        puts("Unable to allocate memory for the sessions.");
+        exit(1);
     }
 
-    return foundPtr;
+    const LogDictionary* clientIps = &table->columns[table->clientIpColumn].dictionary;
+    const LogDictionary* userAgents = table->userAgentColumn >= 0 ? &table->columns[table->userAgentColumn].dictionary : 0;
+
+    for (uint32_t i = 0; i < sessionCount; i++) {
+        const LogSession* session = &sessionTable->sessions.sessions[i];
+        Clay_String* rowCells = sessionTable->cells + (size_t)i * SESSION_COLUMN_COUNT;
+        char* rowText = sessionTable->text + (size_t)i * (SESSION_COLUMN_COUNT - 2) * SESSION_CELL_LIMIT;
+
+        rowCells[0] = (Clay_String){ .chars = clientIps->values[session->clientIpId], .length = (int32_t)clientIps->lengths[session->clientIpId] };
+        rowCells[1] = userAgents ? (Clay_String){ .chars = userAgents->values[session->userAgentId], .length = (int32_t)userAgents->lengths[session->userAgentId] } : CLAY_STRING("-");
+        LogTable_FormatTimestamp(session->start, rowText, SESSION_CELL_LIMIT);
+        LogTable_FormatTimestamp(session->end, rowText + SESSION_CELL_LIMIT, SESSION_CELL_LIMIT);
+        snprintf(rowText + 2 * SESSION_CELL_LIMIT, SESSION_CELL_LIMIT, "%u", session->requestCount);
+        snprintf(rowText + 3 * SESSION_CELL_LIMIT, SESSION_CELL_LIMIT, "%llu", (unsigned long long)session->totalTimeTaken);
+
+        for (int column = 2; column < SESSION_COLUMN_COUNT; column++) {
+            char* cellText = rowText + (column - 2) * SESSION_CELL_LIMIT;
+            rowCells[column] = (Clay_String){ .chars = cellText, .length = (int32_t)strlen(cellText) };
+        }
+    }
 }
 
-int main(void) {
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("Usage: %s <log file> [<log file to compare against>]\n", argv[0]);
+        return 1;
+    }
+
+    int logTableCount = argc > 2 ? 2 : 1;
+    LogTable logTables[2] = { 0 };
+
+    for (int i = 0; i < logTableCount; i++) {
+        int loadResult;
+
+        LOG_PROFILE(LOG_PROFILE_STAGE_LOAD) {
+            loadResult = LogTable_Load(&logTables[i], argv[i + 1]);
+        }
+
+        if (loadResult != 0) {
+            printf("Unable to open file with the provided path: %s\n", argv[i + 1]);
+            return 1;
+        }
+    }
+
+    LogComparison comparison = { 0 };
+    Clay_String* comparisonCells = 0;
+    char* comparisonText = 0;
+
+    if (logTableCount == 2) {
+        if (LogComparison_Build(&comparison, &logTables[0], &logTables[1], "cs-uri-stem") == 0) {
+            comparisonCells = FormatComparisonCells(&comparison, &comparisonText);
+            view = VIEW_COMPARISON;
+        } else {
+            puts("Unable to compare the logs, both of them need a cs-uri-stem field.");
+        }
+    }
+
+    const LogTable* logTable = &logTables[0];
+
+    // The search is only compiled and applied when it changes, frames reuse the matching rows.
+    LogFilter filter = { 0 };
+    char appliedSearchString[2048] = { 0 };
+    uint32_t* filteredRows = malloc((logTable->rowCount > 0 ? logTable->rowCount : 1) * sizeof(uint32_t));
+    uint32_t filteredRowCount;
+    // A malformed search matches nothing, the search info says why.
+    int searchIsInvalid;
+    char patternHits[PATTERN_HITS_LIMIT] = { 0 };
+
+    LOG_PROFILE(LOG_PROFILE_STAGE_SEARCH) {
+        searchIsInvalid = LogFilter_Compile(&filter, logTable, appliedSearchString) != 0;
+        filteredRowCount = LogFilter_Apply(&filter, logTable, filteredRows);
+    }
+
+    LogProfile_SetCounter(LOG_PROFILE_COUNTER_ROWS_SCANNED, logTable->rowCount);
+
+    ClientTable clients = { 0 };
+    int clientTableIsStale = 1;
+    GroupTable routes = { 0 };
+    int routeTableIsStale = 1;
+    SessionTable sessions = { 0 };
+    int sessionTableIsStale = 1;
+
+    // Exports run on a worker thread, the search info shows their progress.
+    LogExport logExport = { 0 };
+    int exportIsRunning = 0;
+    char exportStatus[LOG_EXPORT_PATH_LIMIT + 64] = { 0 };
+    char profileStatus[LOG_EXPORT_PATH_LIMIT + 64] = { 0 };
+    // Text of the search info. Frames that skip layout draw the last render commands again, which
+    // still point into it, so it has to outlive the frame it was written in.
+    char foundRecordsBuffer[2248] = { 0 };
+
     Clay_Raylib_Initialize(1600, 900, "IIS Log Viewer", FLAG_WINDOW_RESIZABLE | FLAG_WINDOW_HIGHDPI | FLAG_MSAA_4X_HINT | FLAG_VSYNC_HINT);
     
+    Clay_SetMaxElementCount(TABLE_LAYOUT_MAX_ELEMENTS);
     uint64_t clayRequiredMemory = Clay_MinMemorySize();
     Clay_Arena clayMemory = Clay_CreateArenaWithCapacityAndMemory(clayRequiredMemory, malloc(clayRequiredMemory));
     Clay_Initialize(clayMemory,(Clay_Dimensions){.width = GetScreenWidth(), .height = GetScreenHeight()},(Clay_ErrorHandler){HandleClayErrors});
@@ -165,25 +678,299 @@ int main(void) {
     
     SetTextureFilter(fonts[FONT_ID_BODY_16].texture, TEXTURE_FILTER_BILINEAR);
     Clay_SetMeasureTextFunction(Raylib_MeasureText, fonts);
+
+    RowsGrid rowsGrid = { .table = logTable, .rows = filteredRows };
+    RowsGrid_FitColumns(&rowsGrid, fonts);
+    float rowsGridWidth = 0;
+
+    Clay_String* rowsHeaders = calloc(logTable->columnCount + 1, sizeof(Clay_String));
+
+    for (int column = 0; column < logTable->columnCount; column++) {
+        rowsGridWidth += rowsGrid.columnWidths[column];
+        rowsHeaders[column] = (Clay_String){ .chars = logTable->columns[column].name, .length = (int32_t)strlen(logTable->columns[column].name) };
+    }
+
+    CustomLayoutElement rowsGridElement = {
+        .type = CUSTOM_LAYOUT_ELEMENT_TYPE_TABLE_GRID,
+        .customData.tableGrid = {
+            .userData = &rowsGrid,
+            .getCell = RowsGrid_GetCell,
+            .columnCount = logTable->columnCount,
+            .columnWidths = rowsGrid.columnWidths,
+            .rowHeight = ROW_HEIGHT,
+            .cellPadding = CELL_PADDING,
+            .fontId = FONT_ID_BODY_16,
+            .fontSize = FONT_SIZE,
+            .textColor = FOREGROUND_COLOR,
+            .lineColor = FOREGROUND_COLOR
+        }
+    };
+    TableScroll rowsScroll = { 0 };
+    // Start of the session that was clicked, the rows view jumps to it once its client's rows are filtered.
+    int64_t sessionJumpTimestamp = LOG_INVALID_NUMBER;
+    // The grouped views scroll the same way, from the top whenever their table changes.
+    TableScroll linesScroll = { 0 };
+    char jumpStatus[128] = { 0 };
+    // Column edges in the header of the rows view drag to resize the columns.
+    int resizingColumn = -1;
+    float resizeStartX = 0;
+    float resizeStartWidth = 0;
+    int mouseCursor = MOUSE_CURSOR_DEFAULT;
     
-    FILE* file = fopen("../example_log.txt", "r"); // TODO: read the file path from args
-    char* logFileContent = ReadFileContent(file);
-    size_t logFileContentSize = strlen(logFileContent);
-    size_t cellsInFile = CountCellsInFile(logFileContent);
-    char** arrayOfCellBuffers = calloc(sizeof(char*), cellsInFile);
-    
+    // Layout only runs when something could have changed it. Otherwise the last frame is drawn again and
+    // EndDrawing blocks until the next event, so an idle viewer doesn't use any CPU.
+    Clay_RenderCommandArray renderCommands = { 0 };
+    int layoutIsStale = 1;
+    int isWaitingForEvents = 1;
+    // The renderer keeps the table lines in a texture while they only scroll, this tells it when they changed.
+    uint64_t tableLinesVersion = 0;
+    View tableLinesView = view;
+    double tableLinesScrollX = 0;
+    double tableLinesScrollY = 0;
+    // Lines of the table in the last layout, which scrolling is clamped to.
+    uint64_t tableLineCount = 0;
+
     while (!WindowShouldClose()) {
-        int arrayOfCellBuffersIndex = 0;
-        int numberOfValidLinesInFile = 0;
-        int numberOfCells = 0;
-        
+        // Exports report progress from their thread, which doesn't wake the event loop, so poll while they run.
+        if (isWaitingForEvents == exportIsRunning) {
+            isWaitingForEvents = !exportIsRunning;
+
+            if (isWaitingForEvents) {
+                EnableEventWaiting();
+            } else {
+                DisableEventWaiting();
+            }
+        }
+
+        if (!layoutIsStale && !exportIsRunning && !IsWindowResized() && !HasPendingInput()) {
+            BeginDrawing();
+            ClearBackground(BLACK);
+            Clay_Raylib_SetScrollCache(CLAY_ID("TableLines"), BACKGROUND_COLOR, tableLinesVersion, tableLinesScrollX, tableLinesScrollY);
+            Clay_Raylib_Render(renderCommands, fonts);
+            EndDrawing();
+            continue;
+        }
+
+        layoutIsStale = 0;
+        // Everything up to EndDrawing, which only waits for the next vertical blank.
+        uint64_t frameStart = LogProfile_Now();
         Clay_SetLayoutDimensions((Clay_Dimensions){.width = GetScreenWidth(), .height = GetScreenHeight()});
         
         Vector2 mousePosition = GetMousePosition();
         Vector2 scrollDelta = GetMouseWheelMoveV();
         Clay_SetPointerState((Clay_Vector2){mousePosition.x, mousePosition.y},IsMouseButtonDown(0));
         Clay_UpdateScrollContainers(false, (Clay_Vector2){scrollDelta.x, scrollDelta.y}, GetFrameTime());
-        
+
+        if (clickedSession >= 0 && (uint32_t)clickedSession < sessions.sessions.sessionCount) {
+            // Follow the client through the rows, Backspace in the search bar goes back to everything.
+            const LogSession* session = &sessions.sessions.sessions[clickedSession];
+            snprintf(searchString, sizeof(searchString), "c-ip = %s", logTable->columns[logTable->clientIpColumn].dictionary.values[session->clientIpId]);
+            searchStringIndex = (int)strlen(searchString);
+            sessionJumpTimestamp = session->start;
+            view = VIEW_ROWS;
+        }
+
+        clickedSession = -1;
+
+        if (gridWasClicked && view == VIEW_ROWS) {
+            Clay_ElementData gridData = Clay_GetElementData(CLAY_ID("RowsGrid"));
+            uint64_t row;
+            int column;
+
+            if (gridData.found && Clay_Raylib_HitTestTableGrid(&rowsGridElement.customData.tableGrid, gridData.boundingBox, clickedGridPosition, &row, &column)) {
+                const LogDictionary* dictionary = &logTable->columns[column].dictionary;
+                uint32_t id = LogTable_GetId(logTable, column, filteredRows[row]);
+                snprintf(searchString, sizeof(searchString), "%s = %.*s", logTable->columns[column].name, (int)dictionary->lengths[id], dictionary->values[id]);
+                searchStringIndex = (int)strlen(searchString);
+            }
+        }
+
+        gridWasClicked = 0;
+
+        if (view != VIEW_ROWS || !IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
+            resizingColumn = -1;
+        }
+
+        int hoveredColumnEdge = -1;
+
+        if (view == VIEW_ROWS && resizingColumn < 0) {
+            Clay_ElementData headerData = Clay_GetElementData(CLAY_ID("TableHeader"));
+            Clay_BoundingBox header = headerData.boundingBox;
+            float headerLeft = header.x + GetPixelAlignedScrollOffset(Clay_GetScrollContainerData(CLAY_ID("TableLines"))).x;
+
+            if (headerData.found && mousePosition.y >= header.y && mousePosition.y < header.y + header.height && mousePosition.x >= header.x && mousePosition.x < header.x + header.width) {
+                hoveredColumnEdge = RowsGrid_FindColumnEdge(&rowsGrid, headerLeft, mousePosition.x);
+            }
+
+            if (hoveredColumnEdge >= 0 && IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+                resizingColumn = hoveredColumnEdge;
+                resizeStartX = mousePosition.x;
+                resizeStartWidth = rowsGrid.columnWidths[resizingColumn];
+            }
+        }
+
+        if (resizingColumn >= 0) {
+            float width = resizeStartWidth + mousePosition.x - resizeStartX;
+            width = width > MIN_RESIZED_COLUMN_WIDTH ? width : MIN_RESIZED_COLUMN_WIDTH;
+
+            if (width != rowsGrid.columnWidths[resizingColumn]) {
+                rowsGridWidth += width - rowsGrid.columnWidths[resizingColumn];
+                rowsGrid.columnWidths[resizingColumn] = width;
+                tableLinesVersion++;
+            }
+        }
+
+        int wantedCursor = resizingColumn >= 0 || hoveredColumnEdge >= 0 ? MOUSE_CURSOR_RESIZE_EW : MOUSE_CURSOR_DEFAULT;
+
+        if (wantedCursor != mouseCursor) {
+            mouseCursor = wantedCursor;
+            SetMouseCursor(mouseCursor);
+        }
+
+        // Rows scroll through rowsScroll rather than Clay, sized against the rows area of the last layout.
+        Clay_ElementData tableLinesData = Clay_GetElementData(CLAY_ID("TableLines"));
+        int tableLinesHeight = tableLinesData.found ? (int)tableLinesData.boundingBox.height : GetScreenHeight();
+        int controlIsDown = IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL);
+
+        TableScroll* tableScroll = view == VIEW_ROWS ? &rowsScroll : &linesScroll;
+
+        if (view != VIEW_ROWS || searchBarIsInFocus) {
+            jumpBarIsInFocus = 0;
+        }
+
+        if (view == VIEW_ROWS && !searchBarIsInFocus && controlIsDown && IsKeyPressed(KEY_G)) {
+            jumpBarIsInFocus = !jumpBarIsInFocus;
+            jumpString[0] = 0;
+            jumpStringIndex = 0;
+            jumpStatus[0] = 0;
+        } else if (jumpBarIsInFocus) {
+            int keyPressed = GetKeyPressed();
+
+            if (keyPressed == KEY_ENTER) {
+                jumpBarIsInFocus = 0;
+
+                if (strchr(jumpString, ':') != 0) {
+                    // A time on its own is on the date of the first row in view.
+                    char timestampText[sizeof(jumpString) + 16];
+                    snprintf(timestampText, sizeof(timestampText), "%s", jumpString);
+
+                    if (jumpStringIndex <= 8 && rowsScroll.firstRow < filteredRowCount) {
+                        char dateText[32];
+                        LogTable_FormatTimestamp(LogTable_GetTimestamp(logTable, filteredRows[rowsScroll.firstRow]), dateText, sizeof(dateText));
+                        snprintf(timestampText, sizeof(timestampText), "%.10s %s", dateText, jumpString);
+                    }
+
+                    int64_t timestamp = LogTable_ParseTimestamp(timestampText);
+
+                    if (timestamp == LOG_INVALID_NUMBER) {
+                        snprintf(jumpStatus, sizeof(jumpStatus), "invalid time '%s', expected hh:mm:ss or yyyy-mm-dd hh:mm:ss", jumpString);
+                    } else {
+                        TableScroll_JumpTo(&rowsScroll, LogTable_FindFirstRowAtTime(logTable, filteredRows, filteredRowCount, timestamp), filteredRowCount, tableLinesHeight);
+                    }
+                } else {
+                    char* end;
+                    unsigned long long rowNumber = strtoull(jumpString, &end, 10);
+
+                    if (end == jumpString || *end != 0 || rowNumber == 0) {
+                        snprintf(jumpStatus, sizeof(jumpStatus), "'%s' isn't a row number to jump to", jumpString);
+                    } else {
+                        TableScroll_JumpTo(&rowsScroll, rowNumber - 1, filteredRowCount, tableLinesHeight);
+                    }
+                }
+            } else if (keyPressed != 0 && !controlIsDown) {
+                TypeKey(jumpString, &jumpStringIndex, sizeof(jumpString), keyPressed);
+            }
+        } else if (!searchBarIsInFocus) {
+            int64_t pageHeight = tableLinesHeight > 2 * ROW_HEIGHT ? (tableLinesHeight / ROW_HEIGHT - 1) * ROW_HEIGHT : ROW_HEIGHT;
+            int64_t scrollPixels = 0;
+
+            if (Clay_PointerOver(CLAY_ID("TableLines"))) {
+                scrollPixels -= (int64_t)roundf(scrollDelta.y * WHEEL_SCROLL_PIXELS);
+            }
+
+            if (IsKeyPressed(KEY_DOWN) || IsKeyPressedRepeat(KEY_DOWN)) scrollPixels += ROW_HEIGHT;
+            if (IsKeyPressed(KEY_UP) || IsKeyPressedRepeat(KEY_UP)) scrollPixels -= ROW_HEIGHT;
+            if (IsKeyPressed(KEY_PAGE_DOWN) || IsKeyPressedRepeat(KEY_PAGE_DOWN)) scrollPixels += pageHeight;
+            if (IsKeyPressed(KEY_PAGE_UP) || IsKeyPressedRepeat(KEY_PAGE_UP)) scrollPixels -= pageHeight;
+
+            if (IsKeyPressed(KEY_HOME)) {
+                TableScroll_JumpTo(tableScroll, 0, tableLineCount, tableLinesHeight);
+            } else if (IsKeyPressed(KEY_END)) {
+                TableScroll_JumpTo(tableScroll, tableLineCount, tableLineCount, tableLinesHeight);
+            } else if (scrollPixels != 0) {
+                TableScroll_ScrollBy(tableScroll, scrollPixels, tableLineCount, tableLinesHeight);
+            }
+        }
+
+        if (!searchBarIsInFocus && !jumpBarIsInFocus && IsKeyPressed(KEY_TAB)) {
+            view = (View)(view + 1);
+
+            if (view > VIEW_COMPARISON || (view == VIEW_COMPARISON && comparisonCells == 0)) {
+                view = VIEW_ROWS;
+            }
+        }
+
+        if (!searchBarIsInFocus && !jumpBarIsInFocus && !exportIsRunning && view == VIEW_ROWS && controlIsDown) {
+            int exportFormat = IsKeyPressed(KEY_E) ? LOG_EXPORT_FORMAT_CSV :
+                               IsKeyPressed(KEY_J) ? LOG_EXPORT_FORMAT_NDJSON :
+                               IsKeyPressed(KEY_B) ? LOG_EXPORT_FORMAT_COLUMNAR : -1;
+
+            if (exportFormat >= 0) {
+                const char* EXPORT_EXTENSIONS[] = { "csv", "ndjson", "iisc" };
+                char exportPath[LOG_EXPORT_PATH_LIMIT];
+                snprintf(exportPath, sizeof(exportPath), "%s.export.%s", logTable->path, EXPORT_EXTENSIONS[exportFormat]);
+                exportIsRunning = LogExport_Start(&logExport, logTable, filteredRows, filteredRowCount, (LogExportFormat)exportFormat, exportPath) == 0;
+                jumpStatus[0] = 0;
+
+                if (!exportIsRunning) {
+                    snprintf(exportStatus, sizeof(exportStatus), "unable to start exporting to '%s'", exportPath);
+                }
+            }
+        }
+
+        if (exportIsRunning && logExport.isDone) {
+            if (LogExport_Finish(&logExport) == 0) {
+                snprintf(exportStatus, sizeof(exportStatus), "exported %u records to '%s'", logExport.rowCount, logExport.path);
+            } else {
+                snprintf(exportStatus, sizeof(exportStatus), "unable to export to '%s'", logExport.path);
+            }
+
+            exportIsRunning = 0;
+        }
+
+        if (!searchBarIsInFocus && view == VIEW_CLIENTS) {
+            int levelCount = sizeof(IPV4_PREFIX_LENGTHS) / sizeof(IPV4_PREFIX_LENGTHS[0]);
+
+            if (IsKeyPressed(KEY_LEFT) && prefixLevel > 0) {
+                prefixLevel--;
+                clientTableIsStale = 1;
+            } else if (IsKeyPressed(KEY_RIGHT) && prefixLevel < levelCount - 1) {
+                prefixLevel++;
+                clientTableIsStale = 1;
+            }
+        }
+
+        if (!searchBarIsInFocus && !jumpBarIsInFocus && IsKeyPressed(KEY_F3)) {
+            profileOverlayIsVisible = !profileOverlayIsVisible;
+            profileStatus[0] = 0;
+        }
+
+        if (!searchBarIsInFocus && !jumpBarIsInFocus && (IsKeyPressed(KEY_F4) || IsKeyPressed(KEY_F5))) {
+            int isTrace = IsKeyPressed(KEY_F5);
+            char reportPath[LOG_EXPORT_PATH_LIMIT];
+            snprintf(reportPath, sizeof(reportPath), isTrace ? "%s.trace.json" : "%s.profile.csv", logTable->path);
+
+            if (WriteReport(reportPath, isTrace ? LogTrace_Write : LogProfile_Dump) == 0) {
+                snprintf(profileStatus, sizeof(profileStatus), "wrote the %s to '%s'", isTrace ? "trace" : "profile", reportPath);
+            } else {
+                snprintf(profileStatus, sizeof(profileStatus), "unable to write the %s to '%s'", isTrace ? "trace" : "profile", reportPath);
+            }
+
+            profileOverlayIsVisible = 1;
+        }
+
+        LogProfile_End(LOG_PROFILE_STAGE_INPUT, frameStart);
+        uint64_t declareStart = LogProfile_Now();
         Clay_BeginLayout();
         
         CLAY(CLAY_ID("OuterContainer"), { 
@@ -211,192 +998,199 @@ int main(void) {
                     
                     if (keyPressed == KEY_ENTER) {
                         searchBarIsInFocus = 0;
-                    } else if (keyPressed == KEY_BACKSPACE) {
-                        if (searchStringIndex > 0) {
-                            searchString[--searchStringIndex] = 0;
-                        }
                     } else if (keyPressed != 0) {
-                        if (IsKeyDown(KEY_RIGHT_SHIFT) || IsKeyDown(KEY_LEFT_SHIFT)) {
-                            keyPressed = ConvertShiftKey(keyPressed);
-                        }
-                        
-                        if (keyPressed != 0)
-                            searchString[searchStringIndex++] = (char)keyPressed;
+                        TypeKey(searchString, &searchStringIndex, sizeof(searchString), keyPressed);
                     }
                 }
 				
                 Clay_String claySearchString = { .chars = searchString, .length = strlen(searchString) };
                 RenderTextComponent(claySearchString);
             }
-            
-            CLAY(CLAY_ID("Table"), {
-                     .layout = {
-                         .layoutDirection = CLAY_TOP_TO_BOTTOM,
-                         .sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_GROW(0) }
-                     },
-                     .border = BORDER,
-                     .cornerRadius = CLAY_CORNER_RADIUS(10),
-                 }) {
-                // header
-                CLAY(CLAY_ID("TableHeader"), {
-                         .layout = {
-                             .layoutDirection = CLAY_LEFT_TO_RIGHT,
-                             .sizing = { .width = CLAY_SIZING_GROW(100), .height = CLAY_SIZING_FIXED(0) },
-                             .childAlignment = { .x = CLAY_ALIGN_X_CENTER, .y = CLAY_ALIGN_Y_CENTER },
-                             .childGap = 5
-                         },
-                         .border = { .width = { .bottom = 5  }, .color = FOREGROUND_COLOR },
-                     }) {
-                    RenderTextComponent(CLAY_STRING("date"));
-                    RenderTextComponent(CLAY_STRING("time"));
-                    RenderTextComponent(CLAY_STRING("s-ip"));
-                    RenderTextComponent(CLAY_STRING("cs-method"));
-                    RenderTextComponent(CLAY_STRING("cs-uri-stem"));
-                    RenderTextComponent(CLAY_STRING("cs-uri-query"));
-                    RenderTextComponent(CLAY_STRING("s-port"));
-                    RenderTextComponent(CLAY_STRING("cs-username"));
-                    RenderTextComponent(CLAY_STRING("c-ip"));
-                    RenderTextComponent(CLAY_STRING("cs(UserAgent)"));
-                    RenderTextComponent(CLAY_STRING("cs(Referer)"));
-                    RenderTextComponent(CLAY_STRING("sc-status"));
-                    RenderTextComponent(CLAY_STRING("sc-substatus"));
-                    RenderTextComponent(CLAY_STRING("sc-win32-status"));
-                    RenderTextComponent(CLAY_STRING("time-taken"));
-                }
-                
-                CLAY(CLAY_ID("TableLines"), {
-                         .layout = {
-                             .layoutDirection = CLAY_TOP_TO_BOTTOM,
-                             .childAlignment = { .x = CLAY_ALIGN_X_CENTER, .y = CLAY_ALIGN_Y_TOP },
-                             .sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_GROW(0) }
-                         },
-                         .cornerRadius = CLAY_CORNER_RADIUS(10),
-                         .clip = { .vertical = true, .childOffset = Clay_GetScrollOffset() }
-                     }) {
-                    
-                    // lines
-                    char* fileContentCpy = calloc(sizeof(char), logFileContentSize + 1);
-                    strcpy(fileContentCpy, logFileContent);
-                    char* line = strtok(fileContentCpy, LINE_DELIMITER);
-                    
-                    while (line != 0) {
-                        if (line[0] != '#') {
-                            Clay_String cells[15] = { 0 };
-                            int cellsIndex = 0;
-                            int cellBufferIndex = 0;
-                            
-                            arrayOfCellBuffers[arrayOfCellBuffersIndex] = calloc(sizeof(char), CELL_CHAR_LIMIT + 1);
-                            
-                            char* fullCellValue = calloc(sizeof(char), 1);
-                            int fullCellValueIndex = 0;
-                            
-                            char* linePtr = line;
-
-                            int isValidLine = 0;
-                            int shouldCheckForValidLine = strlen(searchString) > 0;
-                            
-                            while (*linePtr != '\0') {
-                                if (*linePtr != CELL_DELIMITER) {
-                                    if (cellBufferIndex < CELL_CHAR_LIMIT) {
-                                        arrayOfCellBuffers[arrayOfCellBuffersIndex][cellBufferIndex++] = *linePtr;
-                                    }
-                                    fullCellValue[fullCellValueIndex++] = *linePtr;
-                                    fullCellValue = realloc(fullCellValue, fullCellValueIndex + 1);
-                                    fullCellValue[fullCellValueIndex] = '\0';
-                                } else {
-                                    numberOfCells++;
-                                    Clay_String clayString = { .chars = arrayOfCellBuffers[arrayOfCellBuffersIndex], .length = cellBufferIndex + 1 };
-                                    cells[cellsIndex++] = clayString;
-
-                                    if (shouldCheckForValidLine && strstr_insensitive(fullCellValue, searchString)) {
-                                        isValidLine = 1;
-                                    }
-
-                                    cellBufferIndex = 0;
-                                    arrayOfCellBuffers[++arrayOfCellBuffersIndex] = calloc(sizeof(char), CELL_CHAR_LIMIT + 1);
-                                    free(fullCellValue);
-                                    fullCellValue = calloc(sizeof(char), 1);
-                                    fullCellValueIndex = 0;
-                                }
-                                
-                                linePtr++;
-                            }
-
-                            numberOfCells++;
-                            Clay_String clayString = { .chars = arrayOfCellBuffers[arrayOfCellBuffersIndex], .length = cellBufferIndex + 1 };
-                            cells[cellsIndex++] = clayString;
-
-                            if (shouldCheckForValidLine && strstr_insensitive(fullCellValue, searchString)) {
-                                isValidLine = 1;
-                            }
-
-                            cellBufferIndex = 0;
-                            arrayOfCellBuffers[++arrayOfCellBuffersIndex] = calloc(sizeof(char), CELL_CHAR_LIMIT + 1);
-
-                            if (!shouldCheckForValidLine || (shouldCheckForValidLine && isValidLine)) {
-                                numberOfValidLinesInFile++;
-                                CLAY_AUTO_ID({.layout = {
-                                                    .sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_FIXED(50) },
-                                                    .childAlignment = { .x = CLAY_ALIGN_X_CENTER, .y = CLAY_ALIGN_Y_TOP },
-                                                },
-                                                .border = { .width = { .bottom = 1 }, .color = FOREGROUND_COLOR },
-                                            }) {
-                                    for (int i = 0; i < cellsIndex; i++)
-                                        RenderTextComponent(cells[i]);
-                                }
-                            }
-                        }
-                        line = strtok(0, LINE_DELIMITER);
-                    }
-                    
-                    free(fileContentCpy);
+
+            if (strcmp(appliedSearchString, searchString) != 0) {
+                strcpy(appliedSearchString, searchString);
+                LogFilter_Free(&filter);
+
+                LOG_PROFILE(LOG_PROFILE_STAGE_SEARCH) {
+                    searchIsInvalid = LogFilter_Compile(&filter, logTable, appliedSearchString) != 0;
+                    filteredRowCount = LogFilter_Apply(&filter, logTable, filteredRows);
+                    FormatPatternHits(&filter, logTable, filteredRows, filteredRowCount, patternHits);
                 }
+
+                LogProfile_SetCounter(LOG_PROFILE_COUNTER_ROWS_SCANNED, logTable->rowCount);
+                rowsScroll = (TableScroll){ 0 };
+                clientTableIsStale = 1;
+                routeTableIsStale = 1;
+                sessionTableIsStale = 1;
+                tableLinesVersion++;
+            }
+
+            if (sessionJumpTimestamp != LOG_INVALID_NUMBER) {
+                TableScroll_JumpTo(&rowsScroll, LogTable_FindFirstRowAtTime(logTable, filteredRows, filteredRowCount, sessionJumpTimestamp), filteredRowCount, tableLinesHeight);
+                sessionJumpTimestamp = LOG_INVALID_NUMBER;
+                tableLinesVersion++;
+            }
+
+            if (view == VIEW_SESSIONS && sessionTableIsStale) {
+                LOG_PROFILE(LOG_PROFILE_STAGE_TABLES) SessionTable_Build(&sessions, logTable, filteredRows, filteredRowCount);
+                sessionTableIsStale = 0;
+                linesScroll = (TableScroll){ 0 };
+                tableLinesVersion++;
+            }
+
+            if (view == VIEW_ROUTES && routeTableIsStale) {
+                LOG_PROFILE(LOG_PROFILE_STAGE_TABLES) GroupTable_Build(&routes, logTable, logTable->routeColumn, filteredRows, filteredRowCount);
+                routeTableIsStale = 0;
+                linesScroll = (TableScroll){ 0 };
+                tableLinesVersion++;
+            }
+
+            if (view == VIEW_CLIENTS && clientTableIsStale) {
+                LOG_PROFILE(LOG_PROFILE_STAGE_TABLES) ClientTable_Build(&clients, logTable, filteredRows, filteredRowCount);
+                clientTableIsStale = 0;
+                linesScroll = (TableScroll){ 0 };
+                tableLinesVersion++;
+            }
+
+            if (view != tableLinesView) {
+                tableLinesView = view;
+                linesScroll = (TableScroll){ 0 };
+                tableLinesVersion++;
             }
             
+            Clay_Vector2 tableLinesOffset = GetPixelAlignedScrollOffset(Clay_GetScrollContainerData(CLAY_ID("TableLines")));
+
+            TableLayout table = { .linesOffset = tableLinesOffset };
+            tableScroll = view == VIEW_ROWS ? &rowsScroll : &linesScroll;
+
+            if (view == VIEW_CLIENTS) {
+                table.headers = CLIENT_HEADERS;
+                table.columnCount = CLIENT_COLUMN_COUNT;
+                table.cells = clients.cells;
+                tableLineCount = clients.prefixCount;
+            } else if (view == VIEW_ROUTES) {
+                table.headers = ROUTE_HEADERS;
+                table.columnCount = GROUP_COLUMN_COUNT;
+                table.cells = routes.cells;
+                tableLineCount = routes.groupCount;
+            } else if (view == VIEW_SESSIONS) {
+                table.headers = SESSION_HEADERS;
+                table.columnCount = SESSION_COLUMN_COUNT;
+                table.cells = sessions.cells;
+                table.onRowHover = HandleSessionClick;
+                tableLineCount = sessions.sessions.sessionCount;
+            } else if (view == VIEW_COMPARISON) {
+                table.headers = COMPARISON_HEADERS;
+                table.columnCount = COMPARISON_COLUMN_COUNT;
+                table.cells = comparisonCells;
+                tableLineCount = comparison.rowCount;
+            } else {
+                table.headers = rowsHeaders;
+                table.columnCount = logTable->columnCount;
+                table.gridData = &rowsGridElement;
+                table.columnWidths = rowsGrid.columnWidths;
+                table.gridWidth = rowsGridWidth;
+                table.onGridHover = HandleGridClick;
+                tableLineCount = filteredRowCount;
+            }
+
+            // Only the lines in view are laid out, shifted up by how far the first one is scrolled out.
+            TableScroll_Clamp(tableScroll, tableLineCount, tableLinesHeight);
+            table.firstRow = tableScroll->firstRow;
+            table.rowCount = TableScroll_CountVisibleRows(tableScroll, tableLineCount, tableLinesHeight);
+            table.linesOffset.y = (float)-tableScroll->offset;
+            tableLinesScrollY = -((double)tableScroll->firstRow * ROW_HEIGHT + tableScroll->offset);
+            tableLinesScrollX = tableLinesOffset.x;
+
+            if (view == VIEW_ROWS) {
+                rowsGridElement.customData.tableGrid.firstRow = rowsScroll.firstRow;
+                rowsGridElement.customData.tableGrid.rowCount = filteredRowCount;
+                table.gridHeight = (float)table.rowCount * ROW_HEIGHT;
+            }
+
+            TableLayout_Declare(&table);
+            
             CLAY(CLAY_ID("SearchInfo"), {
                      .layout = {
                          .layoutDirection = CLAY_LEFT_TO_RIGHT
                      },
                  }) {
-                char foundRecordsBuffer[2248] = { 0 };
-                
-                if (strcmp(searchString, "") == 0) {
-                    sprintf(foundRecordsBuffer, "Found %i records", numberOfValidLinesInFile);
+                if (view == VIEW_CLIENTS) {
+                    snprintf(foundRecordsBuffer, sizeof(foundRecordsBuffer), "Found %u client prefixes (IPv4 /%i, IPv6 /%i) in %u records (Left/Right changes the prefix length, Tab switches views)", clients.prefixCount, IPV4_PREFIX_LENGTHS[prefixLevel], IPV6_PREFIX_LENGTHS[prefixLevel], filteredRowCount);
+                } else if (view == VIEW_ROUTES) {
+                    snprintf(foundRecordsBuffer, sizeof(foundRecordsBuffer), "Found %u routes in %u records (Tab switches views)", routes.groupCount, filteredRowCount);
+                } else if (view == VIEW_SESSIONS) {
+                    snprintf(foundRecordsBuffer, sizeof(foundRecordsBuffer), "Found %u sessions in %u records (click one to follow its client, Tab switches views)", sessions.sessions.sessionCount, filteredRowCount);
+                } else if (view == VIEW_COMPARISON) {
+                    snprintf(foundRecordsBuffer, sizeof(foundRecordsBuffer), "Comparing %u endpoints between '%s' and '%s' (Tab switches views)", comparison.rowCount, logTables[0].path, logTables[1].path);
+                } else if (strcmp(searchString, "") == 0) {
+                    sprintf(foundRecordsBuffer, "Found %u records", filteredRowCount);
+                } else if (searchIsInvalid) {
+                    snprintf(foundRecordsBuffer, sizeof(foundRecordsBuffer), "Invalid search '%s'%s%s", searchString, filter.text[0] != '\0' ? ": " : "", filter.text);
                 } else {
-                    sprintf(foundRecordsBuffer, "Found %i records for '%s'", numberOfValidLinesInFile, searchString);
+                    snprintf(foundRecordsBuffer, sizeof(foundRecordsBuffer), "Found %u records for '%s'%s", filteredRowCount, searchString, patternHits);
+                }
+
+                if (view == VIEW_ROWS) {
+                    size_t length = strlen(foundRecordsBuffer);
+
+                    if (jumpBarIsInFocus) {
+                        snprintf(foundRecordsBuffer + length, sizeof(foundRecordsBuffer) - length, ", go to row number or time (hh:mm:ss or yyyy-mm-dd hh:mm:ss): %s", jumpString);
+                    } else if (jumpStatus[0] != 0) {
+                        snprintf(foundRecordsBuffer + length, sizeof(foundRecordsBuffer) - length, ", %s", jumpStatus);
+                    } else if (exportIsRunning) {
+                        // The path can be longer than what's left of the buffer, only as much of it as fits is shown.
+                        int pathLimit = (int)(sizeof(foundRecordsBuffer) - length);
+                        snprintf(foundRecordsBuffer + length, sizeof(foundRecordsBuffer) - length, ", exporting %u of %u records to '%.*s'", logExport.rowsWritten, logExport.rowCount, pathLimit, logExport.path);
+                    } else if (exportStatus[0] != 0) {
+                        snprintf(foundRecordsBuffer + length, sizeof(foundRecordsBuffer) - length, ", %s", exportStatus);
+                    } else {
+                        snprintf(foundRecordsBuffer + length, sizeof(foundRecordsBuffer) - length, " (Ctrl+G goes to a row or time, Ctrl+E exports them as CSV, Ctrl+J as NDJSON, Ctrl+B as columnar, F3 shows frame timings)");
+                    }
                 }
                 
                 Clay_String foundRecordsClayString = { .chars = foundRecordsBuffer, .length = strlen(foundRecordsBuffer) };
                 RenderTextComponent(foundRecordsClayString);
             }
+
+            if (profileOverlayIsVisible) {
+                RenderProfileOverlay(profileStatus);
+            }
         }
-        
-        Clay_RenderCommandArray renderCommands = Clay_EndLayout();
+
+        LogProfile_End(LOG_PROFILE_STAGE_DECLARE, declareStart);
+        LOG_PROFILE(LOG_PROFILE_STAGE_LAYOUT) renderCommands = Clay_EndLayout();
+        LogProfile_SetCounter(LOG_PROFILE_COUNTER_RENDER_COMMANDS, (uint64_t)renderCommands.length);
+        LogProfile_SetCounter(LOG_PROFILE_COUNTER_ELEMENTS, (uint64_t)Clay_GetCurrentContext()->layoutElements.length);
+        // A click handled during layout only takes effect at the start of the next one.
+        layoutIsStale = clickedSession >= 0 || gridWasClicked;
         
         BeginDrawing();
         ClearBackground(BLACK);
-        Clay_Raylib_Render(renderCommands, fonts);
+        Clay_Raylib_SetScrollCache(CLAY_ID("TableLines"), BACKGROUND_COLOR, tableLinesVersion, tableLinesScrollX, tableLinesScrollY);
+        LOG_PROFILE(LOG_PROFILE_STAGE_RENDER) Clay_Raylib_Render(renderCommands, fonts);
+        LogProfile_End(LOG_PROFILE_STAGE_FRAME, frameStart);
         EndDrawing();
-        
-        for (int i = 0; i < numberOfCells; i++) {
-            if (arrayOfCellBuffers[i] != 0)  {
-                free(arrayOfCellBuffers[i]);
-                arrayOfCellBuffers[i] = 0;
-            }
-        }
-        
-        arrayOfCellBuffersIndex = 0;
     }
     
-    for (int i = 0; i < cellsInFile; i++) {
-        if (arrayOfCellBuffers[i] != 0)  {
-            free(arrayOfCellBuffers[i]);
-            arrayOfCellBuffers[i] = 0;
-        }
+    if (exportIsRunning) {
+        LogExport_Finish(&logExport);
     }
-    free(arrayOfCellBuffers);
-    free(logFileContent);
-    fclose(file);
+
+    ClientTable_Free(&clients);
+    GroupTable_Free(&routes);
+    SessionTable_Free(&sessions);
+    LogFilter_Free(&filter);
+    free(filteredRows);
+    free(comparisonCells);
+    free(rowsHeaders);
+    free(comparisonText);
+    LogComparison_Free(&comparison);
+
+    for (int i = 0; i < logTableCount; i++) {
+        LogTable_Free(&logTables[i]);
+    }
+
     UnloadFont(fonts[FONT_ID_BODY_16]);
     Clay_Raylib_Close();
 }
@@ -0,0 +1,1082 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "engine/log_table.h"
+#include "engine/log_aggregate.h"
+#include "engine/log_filter.h"
+#include "engine/log_session.h"
+#include "engine/log_export.h"
+#include "engine/log_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#endif
+
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+#define OUTPUT_CELL_LIMIT 64
+#define OUTPUT_MAX_COLUMNS (LOG_TABLE_MAX_COLUMNS + 2)
+
+typedef enum {
+    OUTPUT_FORMAT_TSV,
+    OUTPUT_FORMAT_CSV,
+    OUTPUT_FORMAT_NDJSON,
+    OUTPUT_FORMAT_COLUMNAR
+} OutputFormat;
+
+typedef enum {
+    QUERY_ROWS,
+    QUERY_GROUP_BY,
+    QUERY_CLIENTS,
+    QUERY_SESSIONS,
+    QUERY_COMPARE
+} QueryMode;
+
+typedef struct {
+    QueryMode mode;
+    const char* filter;
+    const char* groupBy;
+    int ipv4PrefixLength;
+    int ipv6PrefixLength;
+    uint64_t limit;
+} Query;
+
+typedef struct {
+    const char* names[OUTPUT_MAX_COLUMNS];
+    const char* values[OUTPUT_MAX_COLUMNS];
+    uint32_t lengths[OUTPUT_MAX_COLUMNS];
+    int isNumber[OUTPUT_MAX_COLUMNS];
+    char text[OUTPUT_MAX_COLUMNS][OUTPUT_CELL_LIMIT];
+    int columnCount;
+} OutputRecord;
+
+OutputFormat outputFormat = OUTPUT_FORMAT_TSV;
+// stdout, or the connection being answered in server mode.
+FILE* output = 0;
+int isServing = 0;
+char errorMessage[LOG_FILTER_TEXT_LIMIT + 256] = { 0 };
+
+void PrintUsage(const char* program) {
+    printf("Usage: %s [options] <log file> [<log file>...]\n"
+           "\n"
+           "Options:\n"
+           "  --filter <expression>      same expressions as the viewer's search bar, e.g. 'c-ip in 10.0.0.0/8'\n"
+           "                             or 'any /.env @blocklist.txt', whose rows get the pattern they matched\n"
+           "  --group-by <column>        requests, error rate and time-taken percentiles per value of a column\n"
+           "  --clients <bits>[,<bits>]  requests per client prefix, IPv4 and IPv6 prefix lengths (default 24,48)\n"
+           "  --sessions                 client sessions with a 30 minute inactivity timeout\n"
+           "  --compare                  compare the first two logs by cs-uri-stem (or the --group-by column)\n"
+           "  --limit <count>            print at most this many records\n"
+           "  --format <format>          tsv (default), csv, ndjson, or columnar for the matching rows\n"
+           "                             in the binary format described in engine/log_columnar.h\n"
+           "  --trace <path>             when done, write how long loading, parsing and each query took, on which\n"
+           "                             thread, as Chrome trace JSON (chrome://tracing or ui.perfetto.dev)\n"
+#ifndef _WIN32
+           "  --serve <socket path>      keep the logs loaded and answer JSON requests on a Unix socket:\n"
+           "                             one object per line, e.g. {\"query\":\"group-by\",\"column\":\"route\",\"filter\":\"sc-status = 500\"}\n"
+           "                             with query rows, group-by, clients, sessions, compare or shutdown and\n"
+           "                             file, against, filter, column, limit, ipv4 and ipv6 members, answered\n"
+           "                             with NDJSON records and a {\"status\":...} line\n"
+#endif
+           ,
+           program);
+}
+
+// Returns 0 on success, or when there's no trace to write.
+int WriteTrace(const char* path) {
+    if (path == 0) {
+        return 0;
+    }
+
+    FILE* file = fopen(path, "w");
+    int result = file == 0 || LogTrace_Write(file) != 0;
+
+    if (file != 0 && fclose(file) != 0) {
+        result = 1;
+    }
+
+    if (result != 0) {
+        fprintf(stderr, "Unable to write the trace to '%s'\n", path);
+    }
+
+    return result;
+}
+
+void ReportError(const char* format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    vsnprintf(errorMessage, sizeof(errorMessage), format, arguments);
+    va_end(arguments);
+
+    // The server sends errors back to the client instead.
+    if (!isServing) {
+        fprintf(stderr, "%s\n", errorMessage);
+    }
+}
+
+void WriteJsonString(const char* value, uint32_t length) {
+    fputc('"', output);
+
+    for (uint32_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)value[i];
+
+        if (c == '"' || c == '\\') {
+            fputc('\\', output);
+            fputc(c, output);
+        } else if (c < 0x20) {
+            fprintf(output, "\\u%04x", c);
+        } else {
+            fputc(c, output);
+        }
+    }
+
+    fputc('"', output);
+}
+
+void WriteDelimitedValue(const char* value, uint32_t length) {
+    if (outputFormat == OUTPUT_FORMAT_CSV && strpbrk(value, ",\"\r\n") != 0) {
+        fputc('"', output);
+
+        for (uint32_t i = 0; i < length; i++) {
+            if (value[i] == '"') {
+                fputc('"', output);
+            }
+
+            fputc(value[i], output);
+        }
+
+        fputc('"', output);
+    } else {
+        fwrite(value, 1, length, output);
+    }
+}
+
+void OutputRecord_Reset(OutputRecord* record) {
+    record->columnCount = 0;
+}
+
+void OutputRecord_AddText(OutputRecord* record, const char* name, const char* value, uint32_t length) {
+    int column = record->columnCount++;
+    record->names[column] = name;
+    record->values[column] = value;
+    record->lengths[column] = length;
+    record->isNumber[column] = 0;
+}
+
+void OutputRecord_AddNumber(OutputRecord* record, const char* name, double value, int decimals) {
+    int column = record->columnCount++;
+    snprintf(record->text[column], OUTPUT_CELL_LIMIT, "%.*f", decimals, value);
+    record->names[column] = name;
+    record->values[column] = record->text[column];
+    record->lengths[column] = (uint32_t)strlen(record->text[column]);
+    record->isNumber[column] = 1;
+}
+
+void OutputRecord_AddTimestamp(OutputRecord* record, const char* name, int64_t timestamp) {
+    int column = record->columnCount++;
+    LogTable_FormatTimestamp(timestamp, record->text[column], OUTPUT_CELL_LIMIT);
+    record->names[column] = name;
+    record->values[column] = record->text[column];
+    record->lengths[column] = (uint32_t)strlen(record->text[column]);
+    record->isNumber[column] = 0;
+}
+
+void OutputRecord_WriteHeader(const OutputRecord* record) {
+    if (outputFormat == OUTPUT_FORMAT_NDJSON) {
+        return;
+    }
+
+    for (int column = 0; column < record->columnCount; column++) {
+        WriteDelimitedValue(record->names[column], (uint32_t)strlen(record->names[column]));
+        fputc(column + 1 < record->columnCount ? (outputFormat == OUTPUT_FORMAT_CSV ? ',' : '\t') : '\n', output);
+    }
+}
+
+void OutputRecord_Write(const OutputRecord* record) {
+    if (outputFormat != OUTPUT_FORMAT_NDJSON) {
+        for (int column = 0; column < record->columnCount; column++) {
+            WriteDelimitedValue(record->values[column], record->lengths[column]);
+            fputc(column + 1 < record->columnCount ? (outputFormat == OUTPUT_FORMAT_CSV ? ',' : '\t') : '\n', output);
+        }
+
+        return;
+    }
+
+    fputc('{', output);
+
+    for (int column = 0; column < record->columnCount; column++) {
+        WriteJsonString(record->names[column], (uint32_t)strlen(record->names[column]));
+        fputc(':', output);
+
+        if (record->isNumber[column]) {
+            fwrite(record->values[column], 1, record->lengths[column], output);
+        } else {
+            WriteJsonString(record->values[column], record->lengths[column]);
+        }
+
+        if (column + 1 < record->columnCount) {
+            fputc(',', output);
+        }
+    }
+
+    fputs("}\n", output);
+}
+
+int WriteRows(const LogTable* table, const LogFilter* filter, const uint32_t* rows, uint32_t rowCount, uint64_t limit) {
+    // Rows matched by a pattern list say which pattern, the columnar format has no room for it.
+    int hasPatterns = filter->patternCount > 0 && outputFormat != OUTPUT_FORMAT_COLUMNAR;
+
+    if (outputFormat != OUTPUT_FORMAT_TSV && !hasPatterns) {
+        // Straight from the column store in large batches, same as the viewer's export.
+        LogExportFormat format = outputFormat == OUTPUT_FORMAT_CSV ? LOG_EXPORT_FORMAT_CSV :
+                                 outputFormat == OUTPUT_FORMAT_NDJSON ? LOG_EXPORT_FORMAT_NDJSON : LOG_EXPORT_FORMAT_COLUMNAR;
+        fflush(output);
+
+        return LogExport_Write(table, rows, rowCount < limit ? rowCount : (uint32_t)limit, format, output, 0);
+    }
+
+    OutputRecord record;
+
+    for (uint32_t i = 0; i < rowCount && i < limit; i++) {
+        OutputRecord_Reset(&record);
+
+        for (int column = 0; column < table->columnCount; column++) {
+            OutputRecord_AddText(&record, table->columns[column].name, LogTable_GetValue(table, column, rows[i]), LogTable_GetLength(table, column, rows[i]));
+        }
+
+        if (hasPatterns) {
+            int pattern = LogFilter_GetPattern(filter, table, rows[i]);
+            const char* text = pattern >= 0 ? filter->patterns[pattern] : "";
+            OutputRecord_AddText(&record, "pattern", text, (uint32_t)strlen(text));
+        }
+
+        if (i == 0) {
+            OutputRecord_WriteHeader(&record);
+        }
+
+        OutputRecord_Write(&record);
+    }
+
+    return 0;
+}
+
+int CompareGroupCounts(const void* a, const void* b) {
+    uint32_t left = (*(const LogGroup**)a)->count;
+    uint32_t right = (*(const LogGroup**)b)->count;
+
+    return (left < right) - (left > right);
+}
+
+int WriteGroups(const LogTable* table, const char* columnName, const uint32_t* rows, uint32_t rowCount, uint64_t limit) {
+    int column = LogTable_FindColumn(table, columnName);
+    LogAggregate aggregate;
+
+    if (LogAggregate_Build(&aggregate, table, column, rows, rowCount) != 0) {
+        ReportError("Unable to group '%s' by '%s', the column doesn't exist.", table->path, columnName);
+        return 1;
+    }
+
+    const LogGroup** groups = malloc((aggregate.groupCount + 1) * sizeof(LogGroup*));
+    uint32_t groupCount = 0;
+
+    for (uint32_t id = 0; id < aggregate.groupCount; id++) {
+        if (aggregate.groups[id].count > 0) {
+            groups[groupCount++] = &aggregate.groups[id];
+        }
+    }
+
+    qsort(groups, groupCount, sizeof(LogGroup*), CompareGroupCounts);
+
+    const LogDictionary* keys = &table->columns[column].dictionary;
+    OutputRecord record;
+
+    for (uint32_t i = 0; i < groupCount && i < limit; i++) {
+        const LogGroup* group = groups[i];
+
+        OutputRecord_Reset(&record);
+        OutputRecord_AddText(&record, columnName, keys->values[group->keyId], keys->lengths[group->keyId]);
+        OutputRecord_AddNumber(&record, "requests", group->count, 0);
+        OutputRecord_AddNumber(&record, "errors %", LogGroup_ErrorRate(group) * 100.0, 2);
+        OutputRecord_AddNumber(&record, "p50 ms", group->p50, 0);
+        OutputRecord_AddNumber(&record, "p95 ms", group->p95, 0);
+        OutputRecord_AddNumber(&record, "p99 ms", group->p99, 0);
+
+        if (i == 0) {
+            OutputRecord_WriteHeader(&record);
+        }
+
+        OutputRecord_Write(&record);
+    }
+
+    free(groups);
+    LogAggregate_Free(&aggregate);
+
+    return 0;
+}
+
+int WriteClients(const LogTable* table, const uint32_t* rows, uint32_t rowCount, int ipv4PrefixLength, int ipv6PrefixLength, uint64_t limit) {
+    LogAddressTrie trie;
+
+    if (LogTable_BuildAddressTrie(table, rows, rowCount, &trie) != 0) {
+        ReportError("Unable to group '%s' by client, it has no c-ip field.", table->path);
+        return 1;
+    }
+
+    uint32_t prefixCount = 0;
+    LogAddressPrefix* prefixes = LogAddressTrie_GroupByPrefix(&trie, ipv4PrefixLength, ipv6PrefixLength, &prefixCount);
+    OutputRecord record;
+    char prefixText[LOG_ADDRESS_TEXT_LIMIT];
+
+    for (uint32_t i = 0; i < prefixCount && i < limit; i++) {
+        LogAddress_FormatPrefix(&prefixes[i].prefix, prefixes[i].prefixLength, prefixText, sizeof(prefixText));
+
+        OutputRecord_Reset(&record);
+        OutputRecord_AddText(&record, "c-ip prefix", prefixText, (uint32_t)strlen(prefixText));
+        OutputRecord_AddNumber(&record, "requests", (double)prefixes[i].count, 0);
+        OutputRecord_AddNumber(&record, "share %", rowCount > 0 ? prefixes[i].count * 100.0 / rowCount : 0.0, 2);
+
+        if (i == 0) {
+            OutputRecord_WriteHeader(&record);
+        }
+
+        OutputRecord_Write(&record);
+    }
+
+    free(prefixes);
+    LogAddressTrie_Free(&trie);
+
+    return 0;
+}
+
+int WriteSessions(const LogTable* table, const uint32_t* rows, uint32_t rowCount, uint64_t limit) {
+    LogSessions sessions;
+
+    if (LogSessions_Build(&sessions, table, rows, rowCount, LOG_SESSION_DEFAULT_TIMEOUT) != 0) {
+        ReportError("Unable to build sessions for '%s', it has no c-ip field.", table->path);
+        return 1;
+    }
+
+    const LogDictionary* clientIps = &table->columns[table->clientIpColumn].dictionary;
+    const LogDictionary* userAgents = table->userAgentColumn >= 0 ? &table->columns[table->userAgentColumn].dictionary : 0;
+    OutputRecord record;
+
+    for (uint32_t i = 0; i < sessions.sessionCount && i < limit; i++) {
+        const LogSession* session = &sessions.sessions[i];
+
+        OutputRecord_Reset(&record);
+        OutputRecord_AddText(&record, "c-ip", clientIps->values[session->clientIpId], clientIps->lengths[session->clientIpId]);
+
+        if (userAgents != 0) {
+            OutputRecord_AddText(&record, "cs(UserAgent)", userAgents->values[session->userAgentId], userAgents->lengths[session->userAgentId]);
+        }
+
+        OutputRecord_AddTimestamp(&record, "start", session->start);
+        OutputRecord_AddTimestamp(&record, "end", session->end);
+        OutputRecord_AddNumber(&record, "requests", session->requestCount, 0);
+        OutputRecord_AddNumber(&record, "time-taken ms", (double)session->totalTimeTaken, 0);
+
+        if (i == 0) {
+            OutputRecord_WriteHeader(&record);
+        }
+
+        OutputRecord_Write(&record);
+    }
+
+    LogSessions_Free(&sessions);
+
+    return 0;
+}
+
+void AddComparisonValue(OutputRecord* record, const char* beforeName, const char* afterName, const LogGroup* before, double beforeValue, const LogGroup* after, double afterValue, int decimals) {
+    if (before != 0) {
+        OutputRecord_AddNumber(record, beforeName, beforeValue, decimals);
+    } else {
+        OutputRecord_AddText(record, beforeName, outputFormat == OUTPUT_FORMAT_NDJSON ? "null" : "-", outputFormat == OUTPUT_FORMAT_NDJSON ? 4 : 1);
+        record->isNumber[record->columnCount - 1] = 1;
+    }
+
+    if (after != 0) {
+        OutputRecord_AddNumber(record, afterName, afterValue, decimals);
+    } else {
+        OutputRecord_AddText(record, afterName, outputFormat == OUTPUT_FORMAT_NDJSON ? "null" : "-", outputFormat == OUTPUT_FORMAT_NDJSON ? 4 : 1);
+        record->isNumber[record->columnCount - 1] = 1;
+    }
+}
+
+int WriteComparison(const LogTable* before, const LogTable* after, const char* columnName, uint64_t limit) {
+    LogComparison comparison;
+
+    if (LogComparison_Build(&comparison, before, after, columnName) != 0) {
+        ReportError("Unable to compare the logs, both of them need a %s field.", columnName);
+        return 1;
+    }
+
+    OutputRecord record;
+
+    for (uint32_t i = 0; i < comparison.rowCount && i < limit; i++) {
+        const LogComparisonRow* row = &comparison.rows[i];
+        const LogGroup* b = row->before;
+        const LogGroup* a = row->after;
+
+        OutputRecord_Reset(&record);
+        OutputRecord_AddText(&record, columnName, row->key, row->keyLength);
+        AddComparisonValue(&record, "requests before", "requests after", b, b ? b->count : 0, a, a ? a->count : 0, 0);
+        AddComparisonValue(&record, "errors % before", "errors % after", b, LogGroup_ErrorRate(b) * 100.0, a, LogGroup_ErrorRate(a) * 100.0, 2);
+        AddComparisonValue(&record, "p50 ms before", "p50 ms after", b, b ? b->p50 : 0, a, a ? a->p50 : 0, 0);
+        AddComparisonValue(&record, "p95 ms before", "p95 ms after", b, b ? b->p95 : 0, a, a ? a->p95 : 0, 0);
+        AddComparisonValue(&record, "p99 ms before", "p99 ms after", b, b ? b->p99 : 0, a, a ? a->p99 : 0, 0);
+
+        if (i == 0) {
+            OutputRecord_WriteHeader(&record);
+        }
+
+        OutputRecord_Write(&record);
+    }
+
+    LogComparison_Free(&comparison);
+
+    return 0;
+}
+
+int RunQueryOnRows(const Query* query, const LogTable* table, const LogFilter* filter, const uint32_t* rows, uint32_t rowCount) {
+    switch (query->mode) {
+        case QUERY_GROUP_BY:
+            return WriteGroups(table, query->groupBy, rows, rowCount, query->limit);
+        case QUERY_CLIENTS:
+            return WriteClients(table, rows, rowCount, query->ipv4PrefixLength, query->ipv6PrefixLength, query->limit);
+        case QUERY_SESSIONS:
+            return WriteSessions(table, rows, rowCount, query->limit);
+        default:
+            return WriteRows(table, filter, rows, rowCount, query->limit);
+    }
+}
+
+int RunQuery(const Query* query, const char* path) {
+    LogTable table;
+
+    if (LogTable_Load(&table, path) != 0) {
+        ReportError("Unable to open file with the provided path: %s", path);
+        return 1;
+    }
+
+    LogFilter filter;
+
+    if (LogFilter_Compile(&filter, &table, query->filter) != 0) {
+        ReportError("Invalid filter expression: %s%s%s", query->filter, filter.text[0] != '\0' ? ": " : "", filter.text);
+        LogFilter_Free(&filter);
+        LogTable_Free(&table);
+        return 1;
+    }
+
+    uint32_t* rows = malloc((table.rowCount > 0 ? table.rowCount : 1) * sizeof(uint32_t));
+    uint32_t rowCount;
+    LOG_TRACE("search") rowCount = LogFilter_Apply(&filter, &table, rows);
+    int result = RunQueryOnRows(query, &table, &filter, rows, rowCount);
+
+    free(rows);
+    LogFilter_Free(&filter);
+    LogTable_Free(&table);
+
+    return result;
+}
+
+#ifndef _WIN32
+// Filter results each served log keeps around, least recently used ones are dropped first.
+#define SERVER_FILTER_CACHE_SIZE 8
+#define SERVER_BACKLOG 16
+#define SERVER_MAX_CONNECTIONS 64
+#define SERVER_READ_SIZE 4096
+// Longest request line. A client that sends more without a newline gets an error and is disconnected
+// rather than growing the line buffer without bound.
+#define SERVER_LINE_LIMIT (4 * LOG_FILTER_TEXT_LIMIT)
+
+typedef struct {
+    char expression[LOG_FILTER_TEXT_LIMIT];
+    // Kept compiled for what it tells about each row, like the pattern a row matched.
+    LogFilter filter;
+    uint32_t* rows;
+    uint32_t rowCount;
+    uint64_t lastUse;
+} CachedFilter;
+
+typedef struct {
+    LogTable table;
+    CachedFilter filters[SERVER_FILTER_CACHE_SIZE];
+} ServedTable;
+
+typedef struct {
+    const char* query;
+    const char* file;
+    const char* against;
+    const char* filter;
+    const char* column;
+    int64_t limit;
+    int64_t ipv4PrefixLength;
+    int64_t ipv6PrefixLength;
+} Request;
+
+uint64_t filterUseCounter = 0;
+
+// Decodes the JSON string at *cursor in place, leaving *cursor after its closing quote.
+int ParseJsonString(char** cursor, char** value) {
+    char* in = *cursor + 1;
+    char* out = in;
+    *value = out;
+
+    while (*in != '"') {
+        if (*in == 0 || (unsigned char)*in < 0x20) {
+            return 1;
+        }
+
+        if (*in != '\\') {
+            *out++ = *in++;
+            continue;
+        }
+
+        in++;
+
+        switch (*in++) {
+            case '"': *out++ = '"'; break;
+            case '\\': *out++ = '\\'; break;
+            case '/': *out++ = '/'; break;
+            case 'b': *out++ = '\b'; break;
+            case 'f': *out++ = '\f'; break;
+            case 'n': *out++ = '\n'; break;
+            case 'r': *out++ = '\r'; break;
+            case 't': *out++ = '\t'; break;
+            case 'u': {
+                unsigned int codepoint = 0;
+
+                if (sscanf(in, "%4x", &codepoint) != 1 || codepoint > 0x7f) {
+                    // Log values are matched byte for byte, anything past ASCII should be sent as is.
+                    return 1;
+                }
+
+                *out++ = (char)codepoint;
+                in += 4;
+                break;
+            }
+            default:
+                return 1;
+        }
+    }
+
+    *out = 0;
+    *cursor = in + 1;
+
+    return 0;
+}
+
+// Parses a flat JSON object of string and integer members, which is all requests are made of.
+int ParseRequest(char* line, Request* request) {
+    char* cursor = line;
+
+    while (*cursor == ' ' || *cursor == '\t') {
+        cursor++;
+    }
+
+    if (*cursor++ != '{') {
+        return 1;
+    }
+
+    while (1) {
+        while (*cursor == ' ' || *cursor == '\t' || *cursor == ',') {
+            cursor++;
+        }
+
+        if (*cursor == '}') {
+            // One object per line, anything but whitespace after it makes the request malformed.
+            cursor++;
+
+            while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r') {
+                cursor++;
+            }
+
+            return *cursor != '\0';
+        }
+
+        char* key;
+
+        if (*cursor != '"' || ParseJsonString(&cursor, &key) != 0) {
+            return 1;
+        }
+
+        while (*cursor == ' ' || *cursor == '\t') {
+            cursor++;
+        }
+
+        if (*cursor++ != ':') {
+            return 1;
+        }
+
+        while (*cursor == ' ' || *cursor == '\t') {
+            cursor++;
+        }
+
+        char* text = 0;
+        int64_t number = 0;
+
+        if (*cursor == '"') {
+            if (ParseJsonString(&cursor, &text) != 0) {
+                return 1;
+            }
+        } else {
+            char* end;
+            number = strtoll(cursor, &end, 10);
+
+            if (end == cursor) {
+                return 1;
+            }
+
+            cursor = end;
+        }
+
+        if (strcmp(key, "query") == 0 && text) {
+            request->query = text;
+        } else if (strcmp(key, "file") == 0 && text) {
+            request->file = text;
+        } else if (strcmp(key, "against") == 0 && text) {
+            request->against = text;
+        } else if (strcmp(key, "filter") == 0 && text) {
+            request->filter = text;
+        } else if (strcmp(key, "column") == 0 && text) {
+            request->column = text;
+        } else if (strcmp(key, "limit") == 0 && !text) {
+            request->limit = number;
+        } else if (strcmp(key, "ipv4") == 0 && !text) {
+            request->ipv4PrefixLength = number;
+        } else if (strcmp(key, "ipv6") == 0 && !text) {
+            request->ipv6PrefixLength = number;
+        } else {
+            return 1;
+        }
+    }
+}
+
+ServedTable* FindServedTable(ServedTable* tables, int tableCount, const char* path) {
+    if (path == 0) {
+        return &tables[0];
+    }
+
+    for (int i = 0; i < tableCount; i++) {
+        if (strcmp(tables[i].table.path, path) == 0) {
+            return &tables[i];
+        }
+    }
+
+    ReportError("'%s' isn't one of the logs being served", path);
+
+    return 0;
+}
+
+// Returns the rows matching the expression, compiling and applying it only on a cache miss.
+const CachedFilter* FindFilteredRows(ServedTable* served, const char* expression) {
+    CachedFilter* oldest = &served->filters[0];
+
+    for (int i = 0; i < SERVER_FILTER_CACHE_SIZE; i++) {
+        CachedFilter* cached = &served->filters[i];
+
+        if (cached->rows != 0 && strcmp(cached->expression, expression) == 0) {
+            cached->lastUse = ++filterUseCounter;
+            return cached;
+        }
+
+        if (cached->lastUse < oldest->lastUse) {
+            oldest = cached;
+        }
+    }
+
+    LogFilter filter;
+
+    if (LogFilter_Compile(&filter, &served->table, expression) != 0) {
+        ReportError("Invalid filter expression: %s%s%s", expression, filter.text[0] != '\0' ? ": " : "", filter.text);
+        LogFilter_Free(&filter);
+        return 0;
+    }
+
+    if (oldest->rows == 0) {
+        oldest->rows = malloc((served->table.rowCount > 0 ? served->table.rowCount : 1) * sizeof(uint32_t));
+    }
+
+    LOG_TRACE("search") oldest->rowCount = LogFilter_Apply(&filter, &served->table, oldest->rows);
+    oldest->lastUse = ++filterUseCounter;
+    snprintf(oldest->expression, sizeof(oldest->expression), "%s", expression);
+    LogFilter_Free(&oldest->filter);
+    oldest->filter = filter;
+
+    return oldest;
+}
+
+// Answers one request. Returns 0 on success, 1 on error and 2 when the server should stop.
+int HandleRequest(char* line, ServedTable* tables, int tableCount) {
+    Request request = { .query = "rows", .filter = "", .limit = -1, .ipv4PrefixLength = 24, .ipv6PrefixLength = 48 };
+
+    if (ParseRequest(line, &request) != 0) {
+        ReportError("Malformed request, expected a JSON object of string and integer members");
+        return 1;
+    }
+
+    Query query = {
+        .groupBy = request.column,
+        .limit = request.limit >= 0 ? (uint64_t)request.limit : UINT64_MAX
+    };
+
+    if (strcmp(request.query, "shutdown") == 0) {
+        return 2;
+    } else if (strcmp(request.query, "compare") == 0) {
+        const ServedTable* before = FindServedTable(tables, tableCount, request.file);
+        const ServedTable* after = request.against ? FindServedTable(tables, tableCount, request.against) : (tableCount > 1 ? &tables[1] : 0);
+
+        if (before == 0 || after == 0) {
+            if (after == 0 && request.against == 0) {
+                ReportError("Comparing needs an 'against' log");
+            }
+
+            return 1;
+        }
+
+        return WriteComparison(&before->table, &after->table, request.column ? request.column : "cs-uri-stem", query.limit);
+    } else if (strcmp(request.query, "rows") == 0) {
+        query.mode = QUERY_ROWS;
+    } else if (strcmp(request.query, "group-by") == 0 && request.column != 0) {
+        query.mode = QUERY_GROUP_BY;
+    } else if (strcmp(request.query, "clients") == 0) {
+        query.mode = QUERY_CLIENTS;
+
+        // Checked before narrowing, so a huge length can't wrap around into a valid one.
+        if (request.ipv4PrefixLength < 0 || request.ipv4PrefixLength > 32 || request.ipv6PrefixLength < 0 || request.ipv6PrefixLength > 128) {
+            ReportError("Invalid prefix lengths");
+            return 1;
+        }
+
+        query.ipv4PrefixLength = (int)request.ipv4PrefixLength;
+        query.ipv6PrefixLength = (int)request.ipv6PrefixLength;
+    } else if (strcmp(request.query, "sessions") == 0) {
+        query.mode = QUERY_SESSIONS;
+    } else {
+        ReportError("Unknown query '%s', expected rows, group-by (with a column), clients, sessions, compare or shutdown", request.query);
+        return 1;
+    }
+
+    ServedTable* served = FindServedTable(tables, tableCount, request.file);
+    const CachedFilter* filtered = served ? FindFilteredRows(served, request.filter) : 0;
+
+    if (filtered == 0) {
+        return 1;
+    }
+
+    return RunQueryOnRows(&query, &served->table, &filtered->filter, filtered->rows, filtered->rowCount);
+}
+
+typedef struct {
+    int socket;
+    FILE* out;
+    char* line;
+    size_t lineLength;
+    size_t lineCapacity;
+} ServerConnection;
+
+void ServerConnection_Close(ServerConnection* connection) {
+    if (connection->out != 0) {
+        fclose(connection->out);
+    }
+
+    close(connection->socket);
+    free(connection->line);
+    memset(connection, 0, sizeof(*connection));
+    connection->socket = -1;
+}
+
+void WriteErrorStatus(void) {
+    fputs("{\"status\":\"error\",\"message\":", output);
+    WriteJsonString(errorMessage, (uint32_t)strlen(errorMessage));
+    fputs("}\n", output);
+}
+
+// Reads what the client sent and answers every complete line with its records as NDJSON, then a
+// status line. Returns 0 while the connection stays open, 1 once it's closed and 2 on shutdown.
+int ServerConnection_Read(ServerConnection* connection, ServedTable* tables, int tableCount) {
+    char received[SERVER_READ_SIZE];
+    ssize_t receivedLength = read(connection->socket, received, sizeof(received));
+
+    if (receivedLength <= 0) {
+        return 1;
+    }
+
+    for (ssize_t i = 0; i < receivedLength; i++) {
+        if (received[i] != '\n' && connection->lineLength + 1 >= SERVER_LINE_LIMIT) {
+            output = connection->out;
+            ReportError("Request longer than %d bytes, closing the connection", SERVER_LINE_LIMIT);
+            WriteErrorStatus();
+            fflush(output);
+            return 1;
+        }
+
+        if (connection->lineLength + 1 >= connection->lineCapacity) {
+            size_t capacity = connection->lineCapacity > 0 ? connection->lineCapacity * 2 : 4096;
+            char* line = realloc(connection->line, capacity);
+
+            if (line == 0) {
+                return 1;
+            }
+
+            connection->line = line;
+            connection->lineCapacity = capacity;
+        }
+
+        if (received[i] != '\n') {
+            connection->line[connection->lineLength++] = received[i];
+            continue;
+        }
+
+        connection->line[connection->lineLength] = 0;
+        connection->lineLength = 0;
+        output = connection->out;
+
+        int result = HandleRequest(connection->line, tables, tableCount);
+
+        if (result == 1) {
+            WriteErrorStatus();
+        } else {
+            fputs("{\"status\":\"ok\"}\n", output);
+        }
+
+        if (fflush(output) != 0) {
+            return 1;
+        }
+
+        if (result == 2) {
+            return 2;
+        }
+    }
+
+    return 0;
+}
+
+// Keeps the logs loaded and answers requests on a Unix domain socket until asked to shut down.
+int Serve(const char* socketPath, const char** paths, int pathCount) {
+    ServedTable* tables = calloc(pathCount, sizeof(ServedTable));
+    int tableCount = 0;
+    int result = 1;
+    int listener = -1;
+
+    for (; tableCount < pathCount; tableCount++) {
+        if (LogTable_Load(&tables[tableCount].table, paths[tableCount]) != 0) {
+            fprintf(stderr, "Unable to open file with the provided path: %s\n", paths[tableCount]);
+            goto cleanup;
+        }
+    }
+
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "The socket path is too long: %s\n", socketPath);
+        goto cleanup;
+    }
+
+    strcpy(address.sun_path, socketPath);
+    // A socket left behind by a previous run would make bind fail.
+    unlink(socketPath);
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (listener < 0 || bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listener, SERVER_BACKLOG) != 0) {
+        fprintf(stderr, "Unable to listen on %s\n", socketPath);
+        goto cleanup;
+    }
+
+    // A client hanging up mid-response shouldn't take the server down.
+    signal(SIGPIPE, SIG_IGN);
+    isServing = 1;
+    outputFormat = OUTPUT_FORMAT_NDJSON;
+    fprintf(stderr, "Serving %d log(s) on %s\n", tableCount, socketPath);
+
+    // Connections are multiplexed on this thread, requests are answered one at a time against the
+    // shared caches while idle clients don't hold anyone up.
+    ServerConnection connections[SERVER_MAX_CONNECTIONS];
+    struct pollfd polled[SERVER_MAX_CONNECTIONS + 1];
+    int connectionCount = 0;
+    int isStopping = 0;
+
+    while (!isStopping) {
+        polled[0] = (struct pollfd) { .fd = listener, .events = POLLIN };
+
+        for (int i = 0; i < connectionCount; i++) {
+            polled[i + 1] = (struct pollfd) { .fd = connections[i].socket, .events = POLLIN };
+        }
+
+        if (poll(polled, connectionCount + 1, -1) < 0) {
+            continue;
+        }
+
+        for (int i = connectionCount - 1; i >= 0 && !isStopping; i--) {
+            if (polled[i + 1].revents == 0) {
+                continue;
+            }
+
+            int state = ServerConnection_Read(&connections[i], tables, tableCount);
+            isStopping = state == 2;
+
+            if (state != 0) {
+                ServerConnection_Close(&connections[i]);
+                connections[i] = connections[--connectionCount];
+            }
+        }
+
+        if ((polled[0].revents & POLLIN) != 0 && !isStopping) {
+            int socket = accept(listener, 0, 0);
+            FILE* out = socket >= 0 && connectionCount < SERVER_MAX_CONNECTIONS ? fdopen(dup(socket), "w") : 0;
+
+            if (out != 0) {
+                connections[connectionCount++] = (ServerConnection) { .socket = socket, .out = out };
+            } else if (socket >= 0) {
+                close(socket);
+            }
+        }
+    }
+
+    for (int i = 0; i < connectionCount; i++) {
+        ServerConnection_Close(&connections[i]);
+    }
+
+    output = stdout;
+    result = 0;
+
+cleanup:
+    if (listener >= 0) {
+        close(listener);
+        unlink(socketPath);
+    }
+
+    for (int i = 0; i < tableCount; i++) {
+        for (int j = 0; j < SERVER_FILTER_CACHE_SIZE; j++) {
+            free(tables[i].filters[j].rows);
+            LogFilter_Free(&tables[i].filters[j].filter);
+        }
+
+        LogTable_Free(&tables[i].table);
+    }
+
+    free(tables);
+
+    return result;
+}
+#endif
+
+int main(int argc, char** argv) {
+    Query query = { .mode = QUERY_ROWS, .filter = "", .ipv4PrefixLength = 24, .ipv6PrefixLength = 48, .limit = UINT64_MAX };
+    const char** paths = malloc(argc * sizeof(char*));
+    int pathCount = 0;
+    const char* socketPath = 0;
+    const char* tracePath = 0;
+
+    for (int i = 1; i < argc; i++) {
+        int hasValue = i + 1 < argc;
+
+        if (strcmp(argv[i], "--filter") == 0 && hasValue) {
+            query.filter = argv[++i];
+        } else if (strcmp(argv[i], "--group-by") == 0 && hasValue) {
+            query.groupBy = argv[++i];
+
+            if (query.mode != QUERY_COMPARE) {
+                query.mode = QUERY_GROUP_BY;
+            }
+        } else if (strcmp(argv[i], "--clients") == 0 && hasValue) {
+            query.mode = QUERY_CLIENTS;
+
+            if (sscanf(argv[++i], "%d,%d", &query.ipv4PrefixLength, &query.ipv6PrefixLength) < 1 ||
+                query.ipv4PrefixLength < 0 || query.ipv4PrefixLength > 32 || query.ipv6PrefixLength < 0 || query.ipv6PrefixLength > 128) {
+                ReportError("Invalid prefix lengths: %s", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--sessions") == 0) {
+            query.mode = QUERY_SESSIONS;
+        } else if (strcmp(argv[i], "--compare") == 0) {
+            query.mode = QUERY_COMPARE;
+#ifndef _WIN32
+        } else if (strcmp(argv[i], "--serve") == 0 && hasValue) {
+            socketPath = argv[++i];
+#endif
+        } else if (strcmp(argv[i], "--trace") == 0 && hasValue) {
+            tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--limit") == 0 && hasValue) {
+            query.limit = strtoull(argv[++i], 0, 10);
+        } else if (strcmp(argv[i], "--format") == 0 && hasValue) {
+            i++;
+
+            if (strcmp(argv[i], "tsv") == 0) {
+                outputFormat = OUTPUT_FORMAT_TSV;
+            } else if (strcmp(argv[i], "csv") == 0) {
+                outputFormat = OUTPUT_FORMAT_CSV;
+            } else if (strcmp(argv[i], "ndjson") == 0) {
+                outputFormat = OUTPUT_FORMAT_NDJSON;
+            } else if (strcmp(argv[i], "columnar") == 0) {
+                outputFormat = OUTPUT_FORMAT_COLUMNAR;
+            } else {
+                ReportError("Unknown output format: %s", argv[i]);
+                return 1;
+            }
+        } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            PrintUsage(argv[0]);
+            return 1;
+        } else {
+            paths[pathCount++] = argv[i];
+        }
+    }
+
+    if (outputFormat == OUTPUT_FORMAT_COLUMNAR && query.mode != QUERY_ROWS) {
+        ReportError("The columnar format only holds rows, it can't be combined with aggregates.");
+        return 1;
+    }
+
+    if (pathCount == 0 || (query.mode == QUERY_COMPARE && pathCount != 2)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    output = stdout;
+
+#ifndef _WIN32
+    if (socketPath != 0) {
+        int result = Serve(socketPath, paths, pathCount);
+        free(paths);
+        return result | WriteTrace(tracePath);
+    }
+#endif
+
+    static char outputBuffer[OUTPUT_BUFFER_SIZE];
+    setvbuf(stdout, outputBuffer, _IOFBF, sizeof(outputBuffer));
+
+    int result = 0;
+
+    if (query.mode == QUERY_COMPARE) {
+        LogTable tables[2];
+
+        for (int i = 0; i < 2; i++) {
+            if (LogTable_Load(&tables[i], paths[i]) != 0) {
+                ReportError("Unable to open file with the provided path: %s", paths[i]);
+                return 1;
+            }
+        }
+
+        result = WriteComparison(&tables[0], &tables[1], query.groupBy ? query.groupBy : "cs-uri-stem", query.limit);
+        LogTable_Free(&tables[0]);
+        LogTable_Free(&tables[1]);
+    } else {
+        for (int i = 0; i < pathCount; i++) {
+            result |= RunQuery(&query, paths[i]);
+        }
+    }
+
+    fflush(stdout);
+    free(paths);
+
+    return result | WriteTrace(tracePath);
+}
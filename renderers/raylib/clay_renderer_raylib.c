@@ -12,7 +12,8 @@ Camera Raylib_camera;
 
 typedef enum
 {
-    CUSTOM_LAYOUT_ELEMENT_TYPE_3D_MODEL
+    CUSTOM_LAYOUT_ELEMENT_TYPE_3D_MODEL,
+    CUSTOM_LAYOUT_ELEMENT_TYPE_TABLE_GRID
 } CustomLayoutElementType;
 
 typedef struct
@@ -23,14 +24,58 @@ typedef struct
     Matrix rotation;
 } CustomLayoutElement_3DModel;
 
+// A whole table as one element. Rows are laid out top to bottom from the element's top left corner,
+// starting at firstRow, and only the ones inside the current clip rectangle are asked for their
+// cells and drawn. The element only needs to be as tall as the rows in view.
+typedef struct
+{
+    void *userData;
+    Clay_String (*getCell)(void *userData, uint64_t row, int column);
+    uint64_t firstRow;
+    uint64_t rowCount;
+    int columnCount;
+    const float *columnWidths;
+    float rowHeight;
+    float cellPadding;
+    uint16_t fontId;
+    uint16_t fontSize;
+    Clay_Color textColor;
+    // Drawn as a one pixel line along the bottom of every row.
+    Clay_Color lineColor;
+} CustomLayoutElement_TableGrid;
+
 typedef struct
 {
     CustomLayoutElementType type;
     union {
         CustomLayoutElement_3DModel model;
+        CustomLayoutElement_TableGrid tableGrid;
     } customData;
 } CustomLayoutElement;
 
+// Finds the cell of a table grid laid out in box under point. Returns 0 when there's none.
+int Clay_Raylib_HitTestTableGrid(const CustomLayoutElement_TableGrid *grid, Clay_BoundingBox box, Clay_Vector2 point, uint64_t *row, int *column)
+{
+    if (point.x < box.x || point.y < box.y || point.x >= box.x + box.width || point.y >= box.y + box.height || grid->rowHeight <= 0) return 0;
+
+    uint64_t hitRow = grid->firstRow + (uint64_t)((point.y - box.y) / grid->rowHeight);
+    if (hitRow >= grid->rowCount) return 0;
+
+    float x = box.x;
+
+    for (int i = 0; i < grid->columnCount; i++) {
+        x += grid->columnWidths[i];
+
+        if (point.x < x) {
+            *row = hitRow;
+            *column = i;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 // Get a ray trace from the screen position (i.e mouse) within a specific section of the screen
 Ray GetScreenToWorldPointWithZDistance(Vector2 position, Camera camera, int screenWidth, int screenHeight, float zDistance)
 {
@@ -81,70 +126,475 @@ Ray GetScreenToWorldPointWithZDistance(Vector2 position, Camera camera, int scre
 }
 
 
+#define RAYLIB_MAX_FONTS 8
+#define RAYLIB_ASCII_GLYPH_COUNT 128
+// raylib's default spacing between lines of text, which DrawTextEx adds below each line.
+#define RAYLIB_TEXT_LINE_SPACING 2
+
+typedef struct
+{
+    int codepoint;
+    float advance;
+    int glyphIndex;
+} Raylib_CodepointGlyph;
+
+// Unscaled advance and glyph index of every glyph in a font, so measuring and drawing are one table
+// lookup per character. Sizes only scale the advances, so one table serves every font size.
+typedef struct
+{
+    // The font the table was built from, a different font under the same id rebuilds it.
+    Font font;
+    float asciiAdvances[RAYLIB_ASCII_GLYPH_COUNT];
+    int asciiGlyphIndices[RAYLIB_ASCII_GLYPH_COUNT];
+    // Everything past ASCII, sorted by codepoint.
+    Raylib_CodepointGlyph *codepoints;
+    int codepointCount;
+    // '?', which raylib draws for codepoints the font doesn't have.
+    float fallbackAdvance;
+    int fallbackGlyphIndex;
+} Raylib_FontMetrics;
+
+static Raylib_FontMetrics Raylib_fontMetrics[RAYLIB_MAX_FONTS];
+static Font Raylib_defaultFont;
+
+static float Raylib_GlyphAdvance(const Font *font, int index)
+{
+    if (font->glyphs[index].advanceX != 0) return (float)font->glyphs[index].advanceX;
+    return font->recs[index].width + font->glyphs[index].offsetX;
+}
+
+static int Raylib_CompareCodepoints(const void *a, const void *b)
+{
+    int left = ((const Raylib_CodepointGlyph *)a)->codepoint;
+    int right = ((const Raylib_CodepointGlyph *)b)->codepoint;
+    return (left > right) - (left < right);
+}
+
+static Raylib_FontMetrics *Raylib_GetFontMetrics(Font *fonts, uint16_t fontId)
+{
+    const Font *font = &fonts[fontId];
+    // Font failed to load, likely the fonts are in the wrong place relative to the execution dir.
+    // RayLib ships with a default font, so we can continue with that built in one.
+    if (!font->glyphs) {
+        if (!Raylib_defaultFont.glyphs) Raylib_defaultFont = GetFontDefault();
+        font = &Raylib_defaultFont;
+    }
+
+    Raylib_FontMetrics *metrics = &Raylib_fontMetrics[fontId % RAYLIB_MAX_FONTS];
+    if (metrics->font.glyphs == font->glyphs) return metrics;
+
+    free(metrics->codepoints);
+    memset(metrics, 0, sizeof(*metrics));
+    metrics->font = *font;
+    metrics->codepoints = (Raylib_CodepointGlyph *)malloc((font->glyphCount > 0 ? font->glyphCount : 1) * sizeof(Raylib_CodepointGlyph));
+
+    for (int i = 0; i < font->glyphCount; i++) {
+        if (font->glyphs[i].value == '?') {
+            metrics->fallbackAdvance = Raylib_GlyphAdvance(font, i);
+            metrics->fallbackGlyphIndex = i;
+        }
+    }
+
+    for (int c = 0; c < RAYLIB_ASCII_GLYPH_COUNT; c++) {
+        metrics->asciiAdvances[c] = metrics->fallbackAdvance;
+        metrics->asciiGlyphIndices[c] = metrics->fallbackGlyphIndex;
+    }
+
+    for (int i = 0; i < font->glyphCount; i++) {
+        int value = font->glyphs[i].value;
+
+        if (value >= 0 && value < RAYLIB_ASCII_GLYPH_COUNT) {
+            metrics->asciiAdvances[value] = Raylib_GlyphAdvance(font, i);
+            metrics->asciiGlyphIndices[value] = i;
+        } else if (value >= RAYLIB_ASCII_GLYPH_COUNT) {
+            metrics->codepoints[metrics->codepointCount++] = (Raylib_CodepointGlyph) { value, Raylib_GlyphAdvance(font, i), i };
+        }
+    }
+
+    qsort(metrics->codepoints, metrics->codepointCount, sizeof(Raylib_CodepointGlyph), Raylib_CompareCodepoints);
+    return metrics;
+}
+
+// Returns 0 for codepoints the font doesn't have.
+static const Raylib_CodepointGlyph *Raylib_FindCodepoint(const Raylib_FontMetrics *metrics, int codepoint)
+{
+    int low = 0;
+    int high = metrics->codepointCount - 1;
+
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        if (metrics->codepoints[middle].codepoint == codepoint) return &metrics->codepoints[middle];
+        if (metrics->codepoints[middle].codepoint < codepoint) low = middle + 1;
+        else high = middle - 1;
+    }
+
+    return 0;
+}
+
+static float Raylib_FindCodepointAdvance(const Raylib_FontMetrics *metrics, int codepoint)
+{
+    const Raylib_CodepointGlyph *glyph = Raylib_FindCodepoint(metrics, codepoint);
+    return glyph ? glyph->advance : metrics->fallbackAdvance;
+}
+
+// Decodes one UTF-8 sequence without reading past length, like GetCodepointNext invalid bytes come back as '?'.
+static int Raylib_DecodeCodepoint(const unsigned char *chars, int length, int *size)
+{
+    int expected = chars[0] >= 0xF0 ? 4 : chars[0] >= 0xE0 ? 3 : chars[0] >= 0xC0 ? 2 : 0;
+    *size = 1;
+    if (expected == 0 || expected > length || chars[0] > 0xF4) return '?';
+
+    int codepoint = chars[0] & (0x7F >> expected);
+
+    for (int i = 1; i < expected; i++) {
+        if ((chars[i] & 0xC0) != 0x80) return '?';
+        codepoint = (codepoint << 6) | (chars[i] & 0x3F);
+    }
+
+    *size = expected;
+    return codepoint;
+}
+
+// Sums the advances of one line. ASCII goes four bytes at a time into separate sums, so the adds
+// don't wait on each other, and only bytes past ASCII get decoded and looked up.
+static float Raylib_MeasureLine(const Raylib_FontMetrics *metrics, const unsigned char *chars, int length, int *charCount)
+{
+    const float *advances = metrics->asciiAdvances;
+    float sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+    int count = 0;
+    int i = 0;
+
+    while (i < length) {
+        if (i + 4 <= length && ((chars[i] | chars[i + 1] | chars[i + 2] | chars[i + 3]) & 0x80) == 0) {
+            sum0 += advances[chars[i]];
+            sum1 += advances[chars[i + 1]];
+            sum2 += advances[chars[i + 2]];
+            sum3 += advances[chars[i + 3]];
+            i += 4;
+            count += 4;
+        } else if (chars[i] < 0x80) {
+            sum0 += advances[chars[i++]];
+            count++;
+        } else {
+            int size;
+            sum0 += Raylib_FindCodepointAdvance(metrics, Raylib_DecodeCodepoint(chars + i, length - i, &size));
+            i += size;
+            count++;
+        }
+    }
+
+    *charCount = count;
+    return (sum0 + sum1) + (sum2 + sum3);
+}
+
 static inline Clay_Dimensions Raylib_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
     // Measure string size for Font
     Clay_Dimensions textSize = { 0 };
+    Raylib_FontMetrics *metrics = Raylib_GetFontMetrics((Font*)userData, config->fontId);
+    const unsigned char *chars = (const unsigned char *)text.chars;
 
     float maxTextWidth = 0.0f;
-    float lineTextWidth = 0;
-    int maxLineCharCount = 0;
     int lineCharCount = 0;
+    int lineStart = 0;
 
-    float textHeight = config->fontSize;
-    Font* fonts = (Font*)userData;
-    Font fontToUse = fonts[config->fontId];
-    // Font failed to load, likely the fonts are in the wrong place relative to the execution dir.
-    // RayLib ships with a default font, so we can continue with that built in one. 
-    if (!fontToUse.glyphs) {
-        fontToUse = GetFontDefault();
+    while (lineStart <= text.length) {
+        const unsigned char *lineEnd = (const unsigned char *)memchr(chars + lineStart, '\n', text.length - lineStart);
+        int lineLength = lineEnd ? (int)(lineEnd - chars) - lineStart : text.length - lineStart;
+        float lineTextWidth = Raylib_MeasureLine(metrics, chars + lineStart, lineLength, &lineCharCount);
+
+        if (lineTextWidth > maxTextWidth) maxTextWidth = lineTextWidth;
+        lineStart += lineLength + 1;
     }
 
-    float scaleFactor = config->fontSize/(float)fontToUse.baseSize;
+    float scaleFactor = config->fontSize/(float)metrics->font.baseSize;
 
-    for (int i = 0; i < text.length; ++i, lineCharCount++)
-    {
-        if (text.chars[i] == '\n') {
-            maxTextWidth = fmax(maxTextWidth, lineTextWidth);
-            maxLineCharCount = CLAY__MAX(maxLineCharCount, lineCharCount);
-            lineTextWidth = 0;
-            lineCharCount = 0;
+    textSize.width = maxTextWidth * scaleFactor + (lineCharCount * config->letterSpacing);
+    textSize.height = config->fontSize;
+
+    return textSize;
+}
+
+// Draws text straight from the slice Clay hands over, the same way DrawTextEx would draw it once
+// NUL-terminated, but with the glyph indices from the metrics table instead of searching the font.
+static void Raylib_DrawText(Raylib_FontMetrics *metrics, const char *text, int length, Vector2 position, float fontSize, float spacing, Color tint)
+{
+    const Font *font = &metrics->font;
+    const unsigned char *chars = (const unsigned char *)text;
+    float scaleFactor = fontSize/(float)font->baseSize;
+    float padding = (float)font->glyphPadding;
+    float offsetX = 0;
+    float offsetY = 0;
+
+    for (int i = 0; i < length;) {
+        int codepoint = chars[i];
+        int size = 1;
+        int glyphIndex;
+        float advance;
+
+        if (codepoint < RAYLIB_ASCII_GLYPH_COUNT) {
+            glyphIndex = metrics->asciiGlyphIndices[codepoint];
+            advance = metrics->asciiAdvances[codepoint];
+        } else {
+            codepoint = Raylib_DecodeCodepoint(chars + i, length - i, &size);
+            const Raylib_CodepointGlyph *glyph = Raylib_FindCodepoint(metrics, codepoint);
+            glyphIndex = glyph ? glyph->glyphIndex : metrics->fallbackGlyphIndex;
+            advance = glyph ? glyph->advance : metrics->fallbackAdvance;
+        }
+
+        i += size;
+
+        if (codepoint == '\n') {
+            offsetX = 0;
+            offsetY += fontSize + RAYLIB_TEXT_LINE_SPACING;
             continue;
         }
-        int index = text.chars[i] - 32;
-        if (fontToUse.glyphs[index].advanceX != 0) lineTextWidth += fontToUse.glyphs[index].advanceX;
-        else lineTextWidth += (fontToUse.recs[index].width + fontToUse.glyphs[index].offsetX);
-    }
 
-    maxTextWidth = fmax(maxTextWidth, lineTextWidth);
-    maxLineCharCount = CLAY__MAX(maxLineCharCount, lineCharCount);
+        if (codepoint != ' ' && codepoint != '\t' && font->glyphCount > 0) {
+            Rectangle glyphRectangle = font->recs[glyphIndex];
+            Rectangle source = { glyphRectangle.x - padding, glyphRectangle.y - padding, glyphRectangle.width + 2*padding, glyphRectangle.height + 2*padding };
+            Rectangle destination = {
+                position.x + offsetX + (font->glyphs[glyphIndex].offsetX - padding)*scaleFactor,
+                position.y + offsetY + (font->glyphs[glyphIndex].offsetY - padding)*scaleFactor,
+                source.width*scaleFactor,
+                source.height*scaleFactor
+            };
+            DrawTexturePro(font->texture, source, destination, (Vector2) { 0, 0 }, 0, tint);
+        }
 
-    textSize.width = maxTextWidth * scaleFactor + (lineCharCount * config->letterSpacing);
-    textSize.height = textHeight;
+        offsetX += advance*scaleFactor + spacing;
+    }
+}
 
-    return textSize;
+// Caches what one scroll container draws in a render texture. While only its scroll offset changes
+// the previous texture is shifted and just the band that scrolled into view is drawn again.
+typedef struct
+{
+    Clay_ElementId elementId;
+    Clay_Color backgroundColor;
+    // Bumped by the caller whenever the contents change for any reason other than scrolling.
+    uint64_t contentVersion;
+    uint64_t renderedVersion;
+    RenderTexture2D textures[2];
+    int current;
+    int isValid;
+    Clay_BoundingBox bounds;
+    // Whole pixels, negative once scrolled like Clay's. Doubles stay exact far past where the
+    // floats of Clay's scroll positions stop telling rows apart.
+    double scrollX;
+    double scrollY;
+    double renderedScrollX;
+    double renderedScrollY;
+} Raylib_ScrollCache;
+
+static Raylib_ScrollCache Raylib_scrollCache;
+#define RAYLIB_NO_CLIP { -1e9f, -1e9f, 2e9f, 2e9f }
+// What the current scissor lets through, in layout coordinates, so custom elements can skip the rest.
+static Clay_BoundingBox Raylib_clip = RAYLIB_NO_CLIP;
+static Clay_RenderCommand *Raylib_exposedCommands = NULL;
+static int Raylib_exposedCommandCapacity = 0;
+
+// Call before Clay_Raylib_Render with where the container's contents are scrolled to. The scroll
+// position has to be whole pixels, and the contents opaque over backgroundColor, for the shifted
+// texture to match a full redraw.
+void Clay_Raylib_SetScrollCache(Clay_ElementId elementId, Clay_Color backgroundColor, uint64_t contentVersion, double scrollX, double scrollY)
+{
+    Raylib_scrollCache.elementId = elementId;
+    Raylib_scrollCache.backgroundColor = backgroundColor;
+    Raylib_scrollCache.contentVersion = contentVersion;
+    Raylib_scrollCache.scrollX = scrollX;
+    Raylib_scrollCache.scrollY = scrollY;
 }
 
 void Clay_Raylib_Initialize(int width, int height, const char *title, unsigned int flags) {
     SetConfigFlags(flags);
     InitWindow(width, height, title);
-//    EnableEventWaiting();
+    EnableEventWaiting();
 }
 
-// A MALLOC'd buffer, that we keep modifying inorder to save from so many Malloc and Free Calls.
-// Call Clay_Raylib_Close() to free
-static char *temp_render_buffer = NULL;
-static int temp_render_buffer_len = 0;
-
-// Call after closing the window to clean up the render buffer
+// Call after closing the window to clean up the renderer's caches
 void Clay_Raylib_Close()
 {
-    if(temp_render_buffer) free(temp_render_buffer);
-    temp_render_buffer_len = 0;
+    for (int i = 0; i < 2; i++) {
+        if (Raylib_scrollCache.textures[i].id != 0) UnloadRenderTexture(Raylib_scrollCache.textures[i]);
+    }
+    memset(&Raylib_scrollCache, 0, sizeof(Raylib_scrollCache));
+    free(Raylib_exposedCommands);
+    Raylib_exposedCommands = NULL;
+    Raylib_exposedCommandCapacity = 0;
+
+    for (int i = 0; i < RAYLIB_MAX_FONTS; i++) {
+        free(Raylib_fontMetrics[i].codepoints);
+        memset(&Raylib_fontMetrics[i], 0, sizeof(Raylib_fontMetrics[i]));
+    }
 
     CloseWindow();
 }
 
 
+void Clay_Raylib_Render(Clay_RenderCommandArray renderCommands, Font* fonts);
+
+// Length of the longest start of a single line of text that still fits in maxWidth with "..." after
+// it, or the whole length when the text fits as it is. prefixWidth gets the width of that start.
+static int Raylib_EllipsizedLength(const Raylib_FontMetrics *metrics, const char *text, int length, float scaleFactor, float maxWidth, float *prefixWidth)
+{
+    const unsigned char *chars = (const unsigned char *)text;
+    float ellipsisWidth = 3 * metrics->asciiAdvances['.'] * scaleFactor;
+    float width = 0;
+    int fitLength = -1;
+    float fitWidth = 0;
+
+    for (int i = 0; i < length;) {
+        int size = 1;
+        float advance = chars[i] < RAYLIB_ASCII_GLYPH_COUNT ? metrics->asciiAdvances[chars[i]] : Raylib_FindCodepointAdvance(metrics, Raylib_DecodeCodepoint(chars + i, length - i, &size));
+
+        if (fitLength < 0 && width + advance * scaleFactor + ellipsisWidth > maxWidth) {
+            fitLength = i;
+            fitWidth = width;
+        }
+
+        width += advance * scaleFactor;
+
+        if (width > maxWidth) {
+            *prefixWidth = fitWidth;
+            return fitLength;
+        }
+
+        i += size;
+    }
+
+    *prefixWidth = width;
+    return length;
+}
+
+static void Raylib_DrawTableGrid(const CustomLayoutElement_TableGrid *grid, Clay_BoundingBox box, Font *fonts)
+{
+    float top = CLAY__MAX(box.y, Raylib_clip.y);
+    float bottom = CLAY__MIN(box.y + box.height, Raylib_clip.y + Raylib_clip.height);
+    float left = CLAY__MAX(box.x, Raylib_clip.x);
+    float right = CLAY__MIN(box.x + box.width, Raylib_clip.x + Raylib_clip.width);
+    if (bottom <= top || right <= left || grid->rowHeight <= 0) return;
+
+    uint64_t firstRow = grid->firstRow + (uint64_t)((top - box.y) / grid->rowHeight);
+    uint64_t endRow = grid->firstRow + (uint64_t)ceilf((bottom - box.y) / grid->rowHeight);
+    if (endRow > grid->rowCount) endRow = grid->rowCount;
+
+    Raylib_FontMetrics *metrics = Raylib_GetFontMetrics(fonts, grid->fontId);
+    Color textColor = CLAY_COLOR_TO_RAYLIB_COLOR(grid->textColor);
+    Color lineColor = CLAY_COLOR_TO_RAYLIB_COLOR(grid->lineColor);
+    float textOffsetY = (grid->rowHeight - grid->fontSize) / 2;
+    float scaleFactor = grid->fontSize / (float)metrics->font.baseSize;
+
+    for (uint64_t row = firstRow; row < endRow; row++) {
+        float y = box.y + (float)(row - grid->firstRow) * grid->rowHeight;
+        float x = box.x;
+
+        for (int column = 0; column < grid->columnCount && x < right; column++) {
+            float width = grid->columnWidths[column];
+
+            if (x + width > left) {
+                // Values wider than their column are cut short with "..." where they're drawn.
+                Clay_String cell = grid->getCell(grid->userData, row, column);
+                Vector2 position = { x + grid->cellPadding, y + textOffsetY };
+                float prefixWidth;
+                int length = Raylib_EllipsizedLength(metrics, cell.chars, cell.length, scaleFactor, width - 2 * grid->cellPadding, &prefixWidth);
+                Raylib_DrawText(metrics, cell.chars, length, position, (float)grid->fontSize, 0, textColor);
+
+                if (length < cell.length) {
+                    Raylib_DrawText(metrics, "...", 3, (Vector2) { position.x + prefixWidth, position.y }, (float)grid->fontSize, 0, textColor);
+                }
+            }
+
+            x += width;
+        }
+
+        DrawRectangle((int)box.x, (int)(y + grid->rowHeight - 1), (int)box.width, 1, lineColor);
+    }
+}
+
+// Draws commands [first, end) of the cached scroll container, which is clipped to bounds.
+static void Raylib_RenderScrollCache(Clay_RenderCommandArray renderCommands, int32_t first, int32_t end, Clay_BoundingBox bounds, Font* fonts)
+{
+    Raylib_ScrollCache *cache = &Raylib_scrollCache;
+    float scale = GetWindowScaleDPI().x;
+    int width = (int)roundf(bounds.width * scale);
+    int height = (int)roundf(bounds.height * scale);
+    if (width <= 0 || height <= 0) return;
+
+    if (cache->textures[0].texture.width != width || cache->textures[0].texture.height != height) {
+        for (int i = 0; i < 2; i++) {
+            if (cache->textures[i].id != 0) UnloadRenderTexture(cache->textures[i]);
+            cache->textures[i] = LoadRenderTexture(width, height);
+        }
+        cache->isValid = 0;
+    }
+
+    double shift = cache->scrollY - cache->renderedScrollY;
+    int canShift = cache->isValid && cache->renderedVersion == cache->contentVersion && cache->scrollX == cache->renderedScrollX &&
+                   memcmp(&bounds, &cache->bounds, sizeof(bounds)) == 0 && fabs(shift) < bounds.height;
+
+    RenderTexture2D *previous = &cache->textures[cache->current];
+    RenderTexture2D *next = &cache->textures[1 - cache->current];
+    // Rows of the texture that have to be drawn, everything when nothing can be reused.
+    int bandTop = 0;
+    int bandBottom = height;
+
+    BeginTextureMode(*next);
+
+    if (canShift) {
+        int shiftPixels = (int)round(shift * scale);
+        DrawTextureRec(previous->texture, (Rectangle) { 0, 0, (float)width, (float)-height }, (Vector2) { 0, (float)shiftPixels }, WHITE);
+        if (shiftPixels < 0) bandTop = height + shiftPixels;
+        else bandBottom = shiftPixels;
+    }
+
+    if (bandBottom > bandTop) {
+        float exposedTop = bounds.y + bandTop / scale;
+        float exposedBottom = bounds.y + bandBottom / scale;
+        int exposedCount = 0;
+
+        if (end - first > Raylib_exposedCommandCapacity) {
+            free(Raylib_exposedCommands);
+            Raylib_exposedCommandCapacity = end - first;
+            Raylib_exposedCommands = (Clay_RenderCommand *)malloc(Raylib_exposedCommandCapacity * sizeof(Clay_RenderCommand));
+            if (Raylib_exposedCommands == NULL) Raylib_exposedCommandCapacity = 0;
+        }
+
+        for (int32_t j = first; j < end && exposedCount < Raylib_exposedCommandCapacity; j++) {
+            Clay_RenderCommand *renderCommand = &renderCommands.internalArray[j];
+            Clay_BoundingBox box = renderCommand->boundingBox;
+            if (renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_START || renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_END) continue;
+            if (box.y + box.height <= exposedTop || box.y >= exposedBottom) continue;
+            Raylib_exposedCommands[exposedCount++] = *renderCommand;
+        }
+
+        Camera2D camera = { .target = { bounds.x, bounds.y }, .zoom = scale };
+        Clay_BoundingBox clip = Raylib_clip;
+        Raylib_clip = (Clay_BoundingBox) { bounds.x, exposedTop, bounds.width, exposedBottom - exposedTop };
+        BeginScissorMode(0, bandTop, width, bandBottom - bandTop);
+        ClearBackground(CLAY_COLOR_TO_RAYLIB_COLOR(cache->backgroundColor));
+        BeginMode2D(camera);
+        Clay_Raylib_Render((Clay_RenderCommandArray) { .capacity = exposedCount, .length = exposedCount, .internalArray = Raylib_exposedCommands }, fonts);
+        EndMode2D();
+        Raylib_clip = clip;
+        // Antialiased edges leave the texture partly transparent, adding opaque black only fixes the alpha.
+        BeginBlendMode(BLEND_ADD_COLORS);
+        DrawRectangle(0, bandTop, width, bandBottom - bandTop, BLACK);
+        EndBlendMode();
+        EndScissorMode();
+    }
+
+    EndTextureMode();
+
+    cache->current = 1 - cache->current;
+    cache->isValid = 1;
+    cache->renderedVersion = cache->contentVersion;
+    cache->bounds = bounds;
+    cache->renderedScrollX = cache->scrollX;
+    cache->renderedScrollY = cache->scrollY;
+
+    DrawTexturePro(next->texture, (Rectangle) { 0, 0, (float)width, (float)-height }, (Rectangle) { bounds.x, bounds.y, bounds.width, bounds.height }, (Vector2) { 0, 0 }, 0, WHITE);
+}
+
 void Clay_Raylib_Render(Clay_RenderCommandArray renderCommands, Font* fonts)
 {
     for (int j = 0; j < renderCommands.length; j++)
@@ -155,21 +605,8 @@ void Clay_Raylib_Render(Clay_RenderCommandArray renderCommands, Font* fonts)
         {
             case CLAY_RENDER_COMMAND_TYPE_TEXT: {
                 Clay_TextRenderData *textData = &renderCommand->renderData.text;
-                Font fontToUse = fonts[textData->fontId];
-    
-                int strlen = textData->stringContents.length + 1;
-    
-                if(strlen > temp_render_buffer_len) {
-                    // Grow the temp buffer if we need a larger string
-                    if(temp_render_buffer) free(temp_render_buffer);
-                    temp_render_buffer = (char *) malloc(strlen);
-                    temp_render_buffer_len = strlen;
-                }
-    
-                // Raylib uses standard C strings so isn't compatible with cheap slices, we need to clone the string to append null terminator
-                memcpy(temp_render_buffer, textData->stringContents.chars, textData->stringContents.length);
-                temp_render_buffer[textData->stringContents.length] = '\0';
-                DrawTextEx(fontToUse, temp_render_buffer, (Vector2){boundingBox.x, boundingBox.y}, (float)textData->fontSize, (float)textData->letterSpacing, CLAY_COLOR_TO_RAYLIB_COLOR(textData->textColor));
+                Raylib_FontMetrics *metrics = Raylib_GetFontMetrics(fonts, textData->fontId);
+                Raylib_DrawText(metrics, textData->stringContents.chars, textData->stringContents.length, (Vector2){boundingBox.x, boundingBox.y}, (float)textData->fontSize, (float)textData->letterSpacing, CLAY_COLOR_TO_RAYLIB_COLOR(textData->textColor));
     
                 break;
             }
@@ -189,11 +626,25 @@ void Clay_Raylib_Render(Clay_RenderCommandArray renderCommands, Font* fonts)
                 break;
             }
             case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
+                if (Raylib_scrollCache.elementId.id != 0 && renderCommand->id == Raylib_scrollCache.elementId.id) {
+                    int32_t end = j + 1;
+                    for (int depth = 0; end < renderCommands.length; end++) {
+                        Clay_RenderCommandType type = renderCommands.internalArray[end].commandType;
+                        if (type == CLAY_RENDER_COMMAND_TYPE_SCISSOR_START) depth++;
+                        if (type == CLAY_RENDER_COMMAND_TYPE_SCISSOR_END && depth-- == 0) break;
+                    }
+                    Raylib_RenderScrollCache(renderCommands, j + 1, end, renderCommand->boundingBox, fonts);
+                    // Carry on after the container's SCISSOR_END
+                    j = end;
+                    break;
+                }
                 BeginScissorMode((int)roundf(boundingBox.x), (int)roundf(boundingBox.y), (int)roundf(boundingBox.width), (int)roundf(boundingBox.height));
+                Raylib_clip = boundingBox;
                 break;
             }
             case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
                 EndScissorMode();
+                Raylib_clip = (Clay_BoundingBox) RAYLIB_NO_CLIP;
                 break;
             }
             case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
@@ -252,6 +703,10 @@ void Clay_Raylib_Render(Clay_RenderCommandArray renderCommands, Font* fonts)
                         EndMode3D();
                         break;
                     }
+                    case CUSTOM_LAYOUT_ELEMENT_TYPE_TABLE_GRID: {
+                        Raylib_DrawTableGrid(&customElement->customData.tableGrid, boundingBox, fonts);
+                        break;
+                    }
                     default: break;
                 }
                 break;
@@ -0,0 +1,149 @@
+#include "table_layout.h"
+
+void TableScroll_Clamp(TableScroll* scroll, uint64_t rowCount, int viewHeight) {
+    uint64_t contentHeight = rowCount * ROW_HEIGHT;
+    uint64_t maxPosition = contentHeight > (uint64_t)viewHeight ? contentHeight - (uint64_t)viewHeight : 0;
+
+    if (scroll->firstRow * ROW_HEIGHT + (uint64_t)scroll->offset > maxPosition) {
+        scroll->firstRow = maxPosition / ROW_HEIGHT;
+        scroll->offset = (int)(maxPosition % ROW_HEIGHT);
+    }
+}
+
+void TableScroll_ScrollBy(TableScroll* scroll, int64_t pixels, uint64_t rowCount, int viewHeight) {
+    int64_t offset = scroll->offset + pixels;
+    // Rows to move by, rounded down so the remaining offset is never negative.
+    int64_t rows = offset >= 0 ? offset / ROW_HEIGHT : -((-offset + ROW_HEIGHT - 1) / ROW_HEIGHT);
+    offset -= rows * ROW_HEIGHT;
+
+    if (rows < 0 && (uint64_t)-rows > scroll->firstRow) {
+        scroll->firstRow = 0;
+        offset = 0;
+    } else {
+        scroll->firstRow = (uint64_t)((int64_t)scroll->firstRow + rows);
+    }
+
+    scroll->offset = (int)offset;
+    TableScroll_Clamp(scroll, rowCount, viewHeight);
+}
+
+void TableScroll_JumpTo(TableScroll* scroll, uint64_t row, uint64_t rowCount, int viewHeight) {
+    scroll->firstRow = row;
+    scroll->offset = 0;
+    TableScroll_Clamp(scroll, rowCount, viewHeight);
+}
+
+uint32_t TableScroll_CountVisibleRows(const TableScroll* scroll, uint64_t rowCount, int viewHeight) {
+    uint64_t visibleRows = (uint64_t)(viewHeight + scroll->offset) / ROW_HEIGHT + 1;
+    uint64_t remainingRows = rowCount > scroll->firstRow ? rowCount - scroll->firstRow : 0;
+
+    return (uint32_t)(visibleRows < remainingRows ? visibleRows : remainingRows);
+}
+
+void RenderTextComponent(Clay_String text) {
+    CLAY_AUTO_ID({
+                     .layout = {
+                         .padding = CLAY_PADDING_ALL(CELL_PADDING),
+                         .sizing = { .width = CLAY_SIZING_GROW(MIN_COLUMN_WIDTH), .height = CLAY_SIZING_GROW(0) },
+                         .childAlignment = { .x = CLAY_ALIGN_X_LEFT, .y = CLAY_ALIGN_Y_CENTER },
+                     },
+                 }) {
+        CLAY_TEXT(text, CLAY_TEXT_CONFIG({
+                                             .fontId = FONT_ID_BODY_16,
+                                             .fontSize = FONT_SIZE,
+                                             .textColor = FOREGROUND_COLOR
+                                         }));
+    }
+}
+
+void RenderColumnHeader(Clay_String text, float width) {
+    CLAY_AUTO_ID({
+                     .layout = {
+                         .padding = { .left = CELL_PADDING, .right = CELL_PADDING },
+                         .sizing = { .width = CLAY_SIZING_FIXED(width), .height = CLAY_SIZING_GROW(0) },
+                         .childAlignment = { .x = CLAY_ALIGN_X_LEFT, .y = CLAY_ALIGN_Y_CENTER },
+                     },
+                     .clip = { .horizontal = true }
+                 }) {
+        CLAY_TEXT(text, CLAY_TEXT_CONFIG({
+                                             .fontId = FONT_ID_BODY_16,
+                                             .fontSize = FONT_SIZE,
+                                             .textColor = FOREGROUND_COLOR
+                                         }));
+    }
+}
+
+void TableLayout_Declare(const TableLayout* table) {
+    int isGrid = table->gridData != 0;
+    float headerScrollX = isGrid ? table->linesOffset.x : 0;
+
+    CLAY(CLAY_ID("Table"), {
+             .layout = {
+                 .layoutDirection = CLAY_TOP_TO_BOTTOM,
+                 .sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_GROW(0) }
+             },
+             .border = BORDER,
+             .cornerRadius = CLAY_CORNER_RADIUS(10),
+         }) {
+        // header
+        // The rows grid scrolls sideways, its column names follow it.
+        CLAY(CLAY_ID("TableHeader"), {
+                 .layout = {
+                     .layoutDirection = CLAY_LEFT_TO_RIGHT,
+                     .sizing = { .width = CLAY_SIZING_GROW(100), .height = CLAY_SIZING_FIXED(0) },
+                     .childAlignment = { .x = isGrid ? CLAY_ALIGN_X_LEFT : CLAY_ALIGN_X_CENTER, .y = CLAY_ALIGN_Y_CENTER },
+                     .childGap = isGrid ? 0 : 5
+                 },
+                 .border = { .width = { .bottom = 5  }, .color = FOREGROUND_COLOR },
+                 .clip = { .horizontal = isGrid, .childOffset = { headerScrollX, 0 } }
+             }) {
+            for (int column = 0; column < table->columnCount; column++) {
+                if (isGrid) {
+                    RenderColumnHeader(table->headers[column], table->columnWidths[column]);
+                } else {
+                    RenderTextComponent(table->headers[column]);
+                }
+            }
+        }
+
+        CLAY(CLAY_ID("TableLines"), {
+                 .layout = {
+                     .layoutDirection = CLAY_TOP_TO_BOTTOM,
+                     .childAlignment = { .x = CLAY_ALIGN_X_CENTER, .y = CLAY_ALIGN_Y_TOP },
+                     .sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_GROW(0) }
+                 },
+                 .cornerRadius = CLAY_CORNER_RADIUS(10),
+                 // The offset comes from TableScroll, the vertical clip keeps Clay from squeezing the lines to fit.
+                 .clip = { .horizontal = isGrid, .vertical = !isGrid, .childOffset = table->linesOffset }
+             }) {
+            if (isGrid) {
+                CLAY(CLAY_ID("RowsGrid"), {
+                         .layout = {
+                             .sizing = { .width = CLAY_SIZING_GROW(table->gridWidth), .height = CLAY_SIZING_FIXED(table->gridHeight) }
+                         },
+                         .custom = { .customData = table->gridData }
+                     }) {
+                    if (table->onGridHover != 0) {
+                        Clay_OnHover(table->onGridHover, (intptr_t)0);
+                    }
+                }
+            } else {
+                for (uint64_t row = table->firstRow; row < table->firstRow + table->rowCount; row++) {
+                    CLAY_AUTO_ID({.layout = {
+                                        .sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_FIXED(ROW_HEIGHT) },
+                                        .childAlignment = { .x = CLAY_ALIGN_X_CENTER, .y = CLAY_ALIGN_Y_TOP },
+                                    },
+                                    .border = { .width = { .bottom = 1 }, .color = FOREGROUND_COLOR },
+                                }) {
+                        if (table->onRowHover != 0) {
+                            Clay_OnHover(table->onRowHover, (intptr_t)row);
+                        }
+
+                        for (int column = 0; column < table->columnCount; column++)
+                            RenderTextComponent(table->cells[(size_t)row * table->columnCount + column]);
+                    }
+                }
+            }
+        }
+    }
+}
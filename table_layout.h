@@ -0,0 +1,68 @@
+#ifndef IIS_TABLE_LAYOUT_H
+#define IIS_TABLE_LAYOUT_H
+
+#include "include/clay.h"
+#include <stdint.h>
+
+// The table of the viewer, without anything raylib, so it can be laid out headless as well.
+
+#define FONT_ID_BODY_16 0
+#define ROW_HEIGHT 50
+#define CELL_PADDING 16
+#define FONT_SIZE 16
+// Columns of the rows view are fitted to at least this.
+#define MIN_COLUMN_WIDTH 100
+// Clay elements a frame can declare, in the viewer and the layout benchmark alike. Tables only
+// declare the lines in view, so this doesn't grow with the log.
+#define TABLE_LAYOUT_MAX_ELEMENTS 8192
+
+static const Clay_Color FOREGROUND_COLOR = {255,255,255,255};
+static const Clay_Color BACKGROUND_COLOR = {0,0,140,255};
+static const Clay_BorderElementConfig BORDER = { .width = { .left = 5, .right = 5, .top = 5, .bottom = 5  }, .color = { 255, 255, 255, 255 } };
+
+typedef void (*TableLayoutHoverFunction)(Clay_ElementId elementId, Clay_PointerData pointerData, intptr_t userData);
+
+// Where a table is scrolled to. It's kept as a row index and a pixel offset into that row
+// instead of one float position, so it stays exact and cheap to move however many rows there are.
+typedef struct {
+    uint64_t firstRow;
+    // Pixels of the first row scrolled out above the view, always less than ROW_HEIGHT.
+    int offset;
+} TableScroll;
+
+// What the table of a view shows. The grouped views get a line of text cells per row, the rows view
+// sets gridData instead and gets a single custom element the renderer draws the visible rows into.
+typedef struct {
+    const Clay_String* headers;
+    int columnCount;
+    // columnCount of them per row, row after row, from the first row of the table.
+    const Clay_String* cells;
+    // The lines in view: only rows firstRow up to firstRow + rowCount are declared.
+    uint64_t firstRow;
+    uint32_t rowCount;
+    // Called with the row index while a line is hovered, can be 0.
+    TableLayoutHoverFunction onRowHover;
+    // Rows view only: the custom element data, its column widths and size, and the grid's hover handler.
+    void* gridData;
+    const float* columnWidths;
+    float gridWidth;
+    float gridHeight;
+    TableLayoutHoverFunction onGridHover;
+    // Scroll offset of the lines. The header of the rows view follows it sideways.
+    Clay_Vector2 linesOffset;
+} TableLayout;
+
+// Keeps the last row from scrolling past the bottom of a view that's viewHeight pixels tall.
+void TableScroll_Clamp(TableScroll* scroll, uint64_t rowCount, int viewHeight);
+void TableScroll_ScrollBy(TableScroll* scroll, int64_t pixels, uint64_t rowCount, int viewHeight);
+void TableScroll_JumpTo(TableScroll* scroll, uint64_t row, uint64_t rowCount, int viewHeight);
+// Rows from scroll->firstRow that are at least partly in view.
+uint32_t TableScroll_CountVisibleRows(const TableScroll* scroll, uint64_t rowCount, int viewHeight);
+
+void RenderTextComponent(Clay_String text);
+// A column name over the rows grid, as wide as the column under it.
+void RenderColumnHeader(Clay_String text, float width);
+// Declares the Table, TableHeader and TableLines elements, inside whatever element is open.
+void TableLayout_Declare(const TableLayout* table);
+
+#endif
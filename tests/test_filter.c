@@ -0,0 +1,78 @@
+#include "engine/log_filter.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_LOG_PATH "test_filter.log"
+
+static const char* TEST_LOG =
+    "#Software: Microsoft Internet Information Services 10.0\n"
+    "#Version: 1.0\n"
+    "#Fields: date time s-ip cs-method cs-uri-stem cs-uri-query s-port cs-username c-ip cs(UserAgent) cs(Referer) sc-status sc-substatus sc-win32-status time-taken\n"
+    "2024-05-01 00:00:01 10.0.0.1 GET /api/orders/123 - 443 - 192.168.1.10 Mozilla/5.0 - 200 0 0 15\n"
+    "2024-05-01 00:00:02 10.0.0.1 GET /api/orders/456 - 443 - 192.168.1.11 curl/8.4.0 - 404 0 0 3\n"
+    "2024-05-01 00:00:03 10.0.0.1 GET /index.html - 443 - 66.249.66.1 Mozilla/5.0+(compatible;+Googlebot/2.1) - 200 0 0 7\n";
+
+typedef struct {
+    const char* expression;
+    uint32_t expectedRows;
+} FilterCase;
+
+static const FilterCase FILTER_CASES[] = {
+    // The route column is derived, searches without a column only see the raw cs-uri-stem.
+    { "orders", 2 },
+    { "{id}", 0 },
+    { "~ {id}", 0 },
+    { "any {id} /ignored", 0 },
+    { "route = /api/orders/{id}", 2 },
+    { "route ~ {id}$", 2 },
+    { "route any {id}", 2 },
+    // So is the agent class: "browser" isn't in the log, "bot" only is in Googlebot's user agent.
+    { "browser", 0 },
+    { "bot", 1 },
+    { "~ ^bot$", 0 },
+    { "agent = bot", 2 },
+    { "agent = browser", 1 },
+    { "agent ~ ^bro", 1 }
+};
+
+int main(void) {
+    FILE* file = fopen(TEST_LOG_PATH, "w");
+
+    if (file == 0 || fputs(TEST_LOG, file) < 0 || fclose(file) != 0) {
+        printf("Unable to write %s\n", TEST_LOG_PATH);
+        return 1;
+    }
+
+    LogTable table;
+
+    if (LogTable_Load(&table, TEST_LOG_PATH) != 0) {
+        printf("Unable to load %s\n", TEST_LOG_PATH);
+        remove(TEST_LOG_PATH);
+        return 1;
+    }
+
+    uint32_t* rows = malloc((table.rowCount + 1) * sizeof(uint32_t));
+    int failureCount = 0;
+
+    for (size_t i = 0; i < sizeof(FILTER_CASES) / sizeof(FILTER_CASES[0]); i++) {
+        LogFilter filter;
+        int compileResult = LogFilter_Compile(&filter, &table, FILTER_CASES[i].expression);
+        uint32_t rowCount = LogFilter_Apply(&filter, &table, rows);
+
+        if (compileResult != 0 || rowCount != FILTER_CASES[i].expectedRows) {
+            printf("'%s' matched %u rows, expected %u%s\n", FILTER_CASES[i].expression, rowCount, FILTER_CASES[i].expectedRows,
+                   compileResult != 0 ? " (didn't compile)" : "");
+            failureCount++;
+        }
+
+        LogFilter_Free(&filter);
+    }
+
+    printf("%d of %d filter cases failed\n", failureCount, (int)(sizeof(FILTER_CASES) / sizeof(FILTER_CASES[0])));
+
+    free(rows);
+    LogTable_Free(&table);
+    remove(TEST_LOG_PATH);
+
+    return failureCount > 0;
+}